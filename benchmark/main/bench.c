@@ -0,0 +1,225 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "bench.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <malloc.h>
+#include <time.h>
+#else
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#endif
+
+static const char *TAG = "bench";
+
+struct bench_ctx {
+    const char *name;       // 当前负载名
+    uint32_t iterations;
+    uint32_t *latency_ns;   // 延迟样本（预先分配，不计入堆峰值）
+    uint32_t latency_count;
+    uint32_t ops;
+    uint32_t stack_peak;
+    size_t heap_base;       // 负载开始时的基准值
+    size_t heap_peak;       // 负载期间堆占用的最大增量
+    struct {
+        const char *name;
+        double value;
+    } metrics[BENCH_MAX_METRICS];  // 负载专属指标
+    uint32_t metric_count;
+};
+
+// ====================== 时钟与堆统计（平台相关） ======================
+#if CONFIG_IDF_TARGET_LINUX
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// linux 目标的堆就是主机 malloc：按已分配字节数采样
+static void bench_heap_begin(bench_ctx_t *ctx)
+{
+    ctx->heap_base = mallinfo2().uordblks;
+    ctx->heap_peak = 0;
+}
+
+static void bench_heap_sample(bench_ctx_t *ctx)
+{
+    size_t used = mallinfo2().uordblks;
+    if (used > ctx->heap_base && used - ctx->heap_base > ctx->heap_peak) {
+        ctx->heap_peak = used - ctx->heap_base;
+    }
+}
+
+static void bench_heap_end(bench_ctx_t *ctx)
+{
+    bench_heap_sample(ctx);
+}
+#else
+uint64_t bench_now_ns(void)
+{
+    return (uint64_t)esp_timer_get_time() * 1000;
+}
+
+// 芯片上用堆的局部最小空闲值，能精确得到负载期间的峰值
+static void bench_heap_begin(bench_ctx_t *ctx)
+{
+    ctx->heap_base = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    ctx->heap_peak = 0;
+    heap_caps_monitor_local_minimum_free_size_start();
+}
+
+static void bench_heap_sample(bench_ctx_t *ctx)
+{
+    (void)ctx;
+}
+
+static void bench_heap_end(bench_ctx_t *ctx)
+{
+    size_t min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+    heap_caps_monitor_local_minimum_free_size_stop();
+    ctx->heap_peak = ctx->heap_base > min_free ? ctx->heap_base - min_free : 0;
+}
+#endif
+
+// ====================== 负载使用的接口 ======================
+uint32_t bench_iterations(const bench_ctx_t *ctx)
+{
+    return ctx->iterations;
+}
+
+void bench_record_latency(bench_ctx_t *ctx, uint64_t latency_ns)
+{
+    if (ctx->latency_count < ctx->iterations) {
+        ctx->latency_ns[ctx->latency_count++] = latency_ns > UINT32_MAX ? UINT32_MAX : (uint32_t)latency_ns;
+    }
+    if ((ctx->latency_count & 63) == 0) {
+        bench_heap_sample(ctx);
+    }
+}
+
+void bench_add_ops(bench_ctx_t *ctx, uint32_t ops)
+{
+    __atomic_fetch_add(&ctx->ops, ops, __ATOMIC_RELAXED);
+}
+
+void bench_report_stack(bench_ctx_t *ctx, uint32_t stack_size)
+{
+    uint32_t used = stack_size - uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t);
+    uint32_t peak = __atomic_load_n(&ctx->stack_peak, __ATOMIC_RELAXED);
+    while (used > peak && !__atomic_compare_exchange_n(&ctx->stack_peak, &peak, used, true,
+                                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    bench_heap_sample(ctx);
+}
+
+void bench_set_metric(bench_ctx_t *ctx, const char *name, double value)
+{
+    for (uint32_t i = 0; i < ctx->metric_count; i++) {
+        if (strcmp(ctx->metrics[i].name, name) == 0) {
+            ctx->metrics[i].value = value;
+            return;
+        }
+    }
+    if (ctx->metric_count < BENCH_MAX_METRICS) {
+        ctx->metrics[ctx->metric_count].name = name;
+        ctx->metrics[ctx->metric_count].value = value;
+        ctx->metric_count++;
+    }
+}
+
+void bench_report_sample(bench_ctx_t *ctx, const void *data, size_t len)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    printf("BENCH_SAMPLE %s ", ctx->name);
+    for (size_t i = 0; i < len; i++) {
+        printf("%02x", bytes[i]);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+// ====================== 执行与输出 ======================
+static int bench_cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_percentile_us(const bench_ctx_t *ctx, uint32_t percent)
+{
+    if (ctx->latency_count == 0) {
+        return 0.0;
+    }
+    uint32_t index = (ctx->latency_count - 1) * percent / 100;
+    return ctx->latency_ns[index] / 1000.0;
+}
+
+static esp_err_t bench_run_one(const bench_workload_t *workload, bench_ctx_t *ctx)
+{
+    ctx->name = workload->name;
+    memset(ctx->latency_ns, 0, sizeof(uint32_t) * ctx->iterations);
+    ctx->latency_count = 0;
+    ctx->ops = 0;
+    ctx->stack_peak = 0;
+    ctx->metric_count = 0;
+
+    bench_heap_begin(ctx);
+    uint64_t start = bench_now_ns();
+    esp_err_t ret = workload->run(ctx);
+    uint64_t elapsed_ns = bench_now_ns() - start;
+    bench_heap_end(ctx);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "负载 %s 执行失败：%s", workload->name, esp_err_to_name(ret));
+        return ret;
+    }
+
+    qsort(ctx->latency_ns, ctx->latency_count, sizeof(uint32_t), bench_cmp_u32);
+    double elapsed_s = elapsed_ns / 1e9;
+    printf("BENCH_RESULT {\"name\":\"%s\",\"ops\":%" PRIu32 ",\"elapsed_ms\":%.3f,"
+           "\"throughput_ops_s\":%.1f,\"p50_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f,"
+           "\"heap_peak_bytes\":%u,\"stack_peak_bytes\":%" PRIu32,
+           workload->name, ctx->ops, elapsed_s * 1e3,
+           elapsed_s > 0 ? ctx->ops / elapsed_s : 0.0,
+           bench_percentile_us(ctx, 50), bench_percentile_us(ctx, 99), bench_percentile_us(ctx, 100),
+           (unsigned)ctx->heap_peak, ctx->stack_peak);
+    for (uint32_t i = 0; i < ctx->metric_count; i++) {
+        printf(",\"%s\":%.3f", ctx->metrics[i].name, ctx->metrics[i].value);
+    }
+    printf("}\n");
+    fflush(stdout);
+    return ESP_OK;
+}
+
+esp_err_t bench_run_all(const bench_workload_t *workloads, size_t count)
+{
+    bench_ctx_t ctx = {
+        .iterations = CONFIG_BENCH_ITERATIONS,
+    };
+    ctx.latency_ns = malloc(sizeof(uint32_t) * ctx.iterations);
+    if (ctx.latency_ns == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t result = ESP_OK;
+    for (size_t i = 0; i < count; i++) {
+        ESP_LOGI(TAG, "运行负载 %s（%" PRIu32 " 次）", workloads[i].name, ctx.iterations);
+        if (bench_run_one(&workloads[i], &ctx) != ESP_OK) {
+            result = ESP_FAIL;
+        }
+    }
+    free(ctx.latency_ns);
+
+    printf("BENCH_DONE %s\n", result == ESP_OK ? "OK" : "FAIL");
+    fflush(stdout);
+    return result;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/*
+ * 基准测试框架：每个负载执行固定的工作量，框架负责计时、统计延迟分位数、
+ * 记录堆/栈峰值，并按一行一个 JSON 的格式输出：
+ *
+ *   BENCH_RESULT {"name":"queue_pipeline","ops":2000,...}
+ *
+ * 主机端 pytest_benchmark.py 解析这些行并与 baseline.json 对比。
+ */
+
+typedef struct bench_ctx bench_ctx_t;
+
+/**
+ * @brief  一个基准负载
+ */
+typedef struct {
+    const char *name;                    // 负载名称（基线文件中的键）
+    esp_err_t (*run)(bench_ctx_t *ctx);  // 执行函数，返回前必须完成全部工作量
+} bench_workload_t;
+
+/**
+ * @brief  单调时钟（纳秒）
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * @brief  本次运行的迭代次数（CONFIG_BENCH_ITERATIONS）
+ */
+uint32_t bench_iterations(const bench_ctx_t *ctx);
+
+/**
+ * @brief  记录一次操作的延迟（每个负载只允许一个任务调用）
+ */
+void bench_record_latency(bench_ctx_t *ctx, uint64_t latency_ns);
+
+/**
+ * @brief  累加完成的操作数（用于吞吐量），任意任务可调用
+ */
+void bench_add_ops(bench_ctx_t *ctx, uint32_t ops);
+
+/**
+ * @brief  负载任务退出前上报自己的栈使用峰值
+ * @param  stack_size  创建任务时指定的栈大小（字节）
+ */
+void bench_report_stack(bench_ctx_t *ctx, uint32_t stack_size);
+
+/**
+ * @brief  附加一个负载专属指标，追加到该负载的 BENCH_RESULT 中
+ * @param  name  指标名（字符串常量），每个负载最多 BENCH_MAX_METRICS 个
+ */
+void bench_set_metric(bench_ctx_t *ctx, const char *name, double value);
+
+#define BENCH_MAX_METRICS  4
+
+/**
+ * @brief  以十六进制输出负载产生的一段原始数据（BENCH_SAMPLE 行），供 pytest 在主机侧校验
+ */
+void bench_report_sample(bench_ctx_t *ctx, const void *data, size_t len);
+
+/**
+ * @brief  依次执行所有负载并输出结果
+ */
+esp_err_t bench_run_all(const bench_workload_t *workloads, size_t count);
+
+// 各负载入口（每个 bench_*.c 一个）
+esp_err_t bench_queue_pipeline(bench_ctx_t *ctx);
+esp_err_t bench_isr_handoff(bench_ctx_t *ctx);
+esp_err_t bench_logging(bench_ctx_t *ctx);
+esp_err_t bench_pwm_curve(bench_ctx_t *ctx);
+esp_err_t bench_partition_lookup(bench_ctx_t *ctx);
+esp_err_t bench_wake_polling(bench_ctx_t *ctx);
+esp_err_t bench_wake_busy_spin(bench_ctx_t *ctx);
+esp_err_t bench_wake_event_driven(bench_ctx_t *ctx);
+esp_err_t bench_overload_drop_newest(bench_ctx_t *ctx);
+esp_err_t bench_overload_drop_oldest(bench_ctx_t *ctx);
+esp_err_t bench_overload_downsample(bench_ctx_t *ctx);
+esp_err_t bench_acq_replay_rate(bench_ctx_t *ctx);
+esp_err_t bench_acq_replay_max(bench_ctx_t *ctx);
+esp_err_t bench_telemetry_text(bench_ctx_t *ctx);
+esp_err_t bench_telemetry_text_full(bench_ctx_t *ctx);
+esp_err_t bench_telemetry_binary(bench_ctx_t *ctx);
+esp_err_t bench_event_bus_publish(bench_ctx_t *ctx);
+esp_err_t bench_event_bus_delivery(bench_ctx_t *ctx);
+esp_err_t bench_event_queues(bench_ctx_t *ctx);
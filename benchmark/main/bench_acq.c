@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include "acq.h"
+#include "acq_source.h"
+#include "bench.h"
+
+/*
+ * 高速采集：用回放数据源代替连续模式 ADC，测试采集核心（拼帧 → 块 → 解码 → 处理）的持续速率和 CPU 占用。
+ *   acq_replay_rate → 4 通道 × 20 kHz 固定速率回放，吞吐量应等于回放速率且不丢帧
+ *   acq_replay_max  → 不限速回放，得到单核能承受的最大帧率（余量）
+ * linux 目标先把合成数据写入文件再从文件回放；芯片/QEMU 直接回放内存数据。
+ * 延迟分位数为块装满到处理任务取到块的时间；cpu_load 由最低优先级的空转任务计数估算
+ * （与空载时的计数比较，多核芯片上只统计 CPU0）。
+ */
+
+#define TASK_STACK_SIZE     4096
+#define ACQ_CHANNELS        4
+#define ACQ_FRAME_RATE_HZ   20000
+#define ACQ_DURATION_MS     2000
+#define ACQ_BLOCK_FRAMES    256
+#define ACQ_BLOCK_COUNT     4
+#define ACQ_SYNTH_FRAMES    1024
+#define ACQ_CALIBRATE_MS    200
+#define ACQ_REPLAY_FILE     "acq_replay.bin"
+
+typedef struct {
+    float volts[ACQ_CHANNELS];
+} acq_item_t;
+
+typedef struct {
+    bench_ctx_t *ctx;
+    acq_handle_t acq;
+    TaskHandle_t waiter;
+    volatile bool running;
+    float mean[ACQ_CHANNELS];
+    uint32_t frames;
+} acq_bench_t;
+
+static const uint8_t s_channels[ACQ_CHANNELS] = { 0, 1, 2, 3 };
+static acq_conv_t s_synth[ACQ_SYNTH_FRAMES * ACQ_CHANNELS];
+
+// ====================== CPU 占用探针 ======================
+static volatile uint32_t s_idle_count;
+static volatile bool s_probe_running;
+
+static void load_probe_task(void *arg)
+{
+    TaskHandle_t waiter = (TaskHandle_t)arg;
+    while (s_probe_running) {
+        s_idle_count++;
+    }
+    xTaskNotifyGive(waiter);
+    vTaskDelete(NULL);
+}
+
+// ====================== 解码与处理 ======================
+static void acq_bench_decode(const uint16_t *raw, uint32_t frames, void *items, void *ctx)
+{
+    acq_item_t *out = (acq_item_t *)items;
+    for (uint32_t i = 0; i < frames; i++) {
+        for (int c = 0; c < ACQ_CHANNELS; c++) {
+            out[i].volts[c] = raw[i * ACQ_CHANNELS + c] * 3.3f / 4096;
+        }
+    }
+}
+
+static void acq_process_task(void *arg)
+{
+    acq_bench_t *bench = (acq_bench_t *)arg;
+    while (bench->running) {
+        acq_block_t *block = acq_receive(bench->acq, pdMS_TO_TICKS(10));
+        if (block == NULL) {
+            continue;
+        }
+        bench_record_latency(bench->ctx, bench_now_ns() - (uint64_t)block->timestamp_us * 1000);
+
+        const acq_item_t *items = (const acq_item_t *)block->items;
+        for (int c = 0; c < ACQ_CHANNELS; c++) {
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < block->frames; i++) {
+                sum += items[i].volts[c];
+            }
+            bench->mean[c] = sum / block->frames;
+        }
+        bench->frames += block->frames;
+        bench_add_ops(bench->ctx, block->frames);
+        acq_release(bench->acq, block);
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+// ====================== 数据源 ======================
+static void acq_bench_synthesize(void)
+{
+    // 各通道为不同周期的三角波，幅度覆盖 12 位满量程
+    for (int i = 0; i < ACQ_SYNTH_FRAMES; i++) {
+        for (int c = 0; c < ACQ_CHANNELS; c++) {
+            int period = 64 << c;
+            int phase = i % period;
+            int tri = phase < period / 2 ? phase : period - phase;
+            s_synth[i * ACQ_CHANNELS + c].channel = s_channels[c];
+            s_synth[i * ACQ_CHANNELS + c].raw = (uint16_t)(tri * 4095 / (period / 2));
+        }
+    }
+}
+
+static esp_err_t acq_bench_new_source(uint32_t frame_rate_hz, acq_source_t **source)
+{
+    acq_bench_synthesize();
+    acq_replay_config_t config = {
+        .conv_rate_hz = frame_rate_hz * ACQ_CHANNELS,
+        .loop = true,
+        .task_priority = 1,
+    };
+#if CONFIG_IDF_TARGET_LINUX
+    FILE *f = fopen(ACQ_REPLAY_FILE, "wb");
+    if (f == NULL) {
+        return ESP_FAIL;
+    }
+    size_t written = fwrite(s_synth, sizeof(acq_conv_t), sizeof(s_synth) / sizeof(s_synth[0]), f);
+    fclose(f);
+    if (written != sizeof(s_synth) / sizeof(s_synth[0])) {
+        return ESP_FAIL;
+    }
+    config.path = ACQ_REPLAY_FILE;
+#else
+    config.data = s_synth;
+    config.count = sizeof(s_synth) / sizeof(s_synth[0]);
+#endif
+    return acq_source_new_replay(&config, source);
+}
+
+// ====================== 公共流程 ======================
+static esp_err_t acq_bench_run(bench_ctx_t *ctx, uint32_t frame_rate_hz)
+{
+    acq_bench_t bench = {
+        .ctx = ctx,
+        .waiter = xTaskGetCurrentTaskHandle(),
+        .running = true,
+    };
+    acq_source_t *source = NULL;
+    esp_err_t ret = acq_bench_new_source(frame_rate_hz, &source);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    acq_config_t config = {
+        .channels = s_channels,
+        .channel_count = ACQ_CHANNELS,
+        .item_size = sizeof(acq_item_t),
+        .block_frames = ACQ_BLOCK_FRAMES,
+        .block_count = ACQ_BLOCK_COUNT,
+        .decode = acq_bench_decode,
+    };
+    ret = acq_create(&config, source, &bench.acq);
+    if (ret != ESP_OK) {
+        source->del(source);
+        return ret;
+    }
+
+    // 空载校准：只有探针在运行时的计数速率
+    s_probe_running = true;
+    s_idle_count = 0;
+    if (xTaskCreatePinnedToCore(load_probe_task, "LoadProbe", TASK_STACK_SIZE, bench.waiter,
+                                tskIDLE_PRIORITY, NULL, 0) != pdPASS) {
+        acq_delete(bench.acq);
+        return ESP_ERR_NO_MEM;
+    }
+    vTaskDelay(pdMS_TO_TICKS(ACQ_CALIBRATE_MS));
+    uint32_t idle_calibrated = s_idle_count;
+
+    // 处理任务优先级高于回放任务：不限速回放时每装满一块立即被处理
+    if (xTaskCreatePinnedToCore(acq_process_task, "ProcessTask", TASK_STACK_SIZE, &bench, 2, NULL, 0) != pdPASS) {
+        ret = ESP_ERR_NO_MEM;
+    }
+    uint32_t idle_start = s_idle_count;
+    if (ret == ESP_OK) {
+        ret = acq_start(bench.acq);
+        if (ret == ESP_OK) {
+            vTaskDelay(pdMS_TO_TICKS(ACQ_DURATION_MS));
+            acq_stop(bench.acq);
+        }
+        bench.running = false;
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);  // 处理任务退出
+    }
+    uint32_t idle_loaded = s_idle_count - idle_start;
+    s_probe_running = false;
+    ulTaskNotifyTake(pdFALSE, portMAX_DELAY);      // 探针任务退出
+
+    if (ret == ESP_OK) {
+        acq_stats_t stats;
+        acq_get_stats(bench.acq, &stats);
+        double idle_ratio = (double)idle_loaded * ACQ_CALIBRATE_MS / ((double)idle_calibrated * ACQ_DURATION_MS);
+        double cpu_load = idle_calibrated > 0 ? 1.0 - idle_ratio : 0.0;
+        bench_set_metric(ctx, "frame_rate_hz", bench.frames * 1000.0 / ACQ_DURATION_MS);
+        bench_set_metric(ctx, "overrun_frames", stats.overrun_frames);
+        bench_set_metric(ctx, "cpu_load", cpu_load < 0 ? 0.0 : (cpu_load > 1 ? 1.0 : cpu_load));
+    }
+    acq_delete(bench.acq);
+#if CONFIG_IDF_TARGET_LINUX
+    remove(ACQ_REPLAY_FILE);
+#endif
+    return ret;
+}
+
+esp_err_t bench_acq_replay_rate(bench_ctx_t *ctx)
+{
+    return acq_bench_run(ctx, ACQ_FRAME_RATE_HZ);
+}
+
+esp_err_t bench_acq_replay_max(bench_ctx_t *ctx)
+{
+    return acq_bench_run(ctx, 0);
+}
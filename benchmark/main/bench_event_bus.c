@@ -0,0 +1,311 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "event_bus.h"
+#include "bench.h"
+
+/*
+ * 事件总线：gpio、multitask/isr.h、touch-element 的按键/触摸/定时器事件改为发布到 components/event_bus。
+ *   event_bus_publish  → 4 个生产者任务并发发布，延迟分位数为单次发布耗时（无锁入队 + 必要时唤醒分发任务）
+ *   event_bus_delivery → 1 个生产者按突发（每次 8 个，模拟中断/定时器成簇到达）发布 4 种主题，
+ *                        8 个订阅者各订阅一种主题，由 2 个分发任务批量交付；延迟分位数为发布到回调的时间
+ *   event_queues       → 改造前的做法：8 个订阅者各有一个任务和一个队列，生产者把事件逐个发送到订阅者的队列
+ * 后两个负载额外输出 wakeups_per_event（消费侧任务每个事件的唤醒次数）和 tasks（消费侧任务数）。
+ */
+
+#define PRODUCERS        4
+#define SUBSCRIBERS      8
+#define DISPATCHERS      2
+#define TOPICS           4
+#define BURST            8
+#define QUEUE_LEN        16
+#define TASK_STACK_SIZE  4096
+
+static const uint32_t s_topics[TOPICS] = {
+    EVENT_TOPIC_GPIO, EVENT_TOPIC_TOUCH, EVENT_TOPIC_TIMER, EVENT_TOPIC_USER,
+};
+
+typedef struct {
+    bench_ctx_t *ctx;
+    event_bus_handle_t bus;
+    TaskHandle_t waiter;
+    uint32_t expected;       // 所有订阅者应收到的事件总数
+    uint32_t received;
+    uint32_t latency_owner;  // 多个分发任务可能并发调用回调，拿到它的回调才记录延迟（bench_record_latency 只能单任务调用）
+    uint32_t ring_full;      // 缓冲区满、等待后重试的次数
+} bus_bench_t;
+
+typedef struct {
+    bus_bench_t *bench;
+    uint32_t index;
+} bus_producer_t;
+
+static uint32_t bench_now_us32(void)
+{
+    return (uint32_t)(bench_now_ns() / 1000);
+}
+
+static void bus_bench_received(bus_bench_t *bench, size_t count)
+{
+    bench_add_ops(bench->ctx, count);
+    uint32_t before = __atomic_fetch_add(&bench->received, count, __ATOMIC_RELAXED);
+    if (before < bench->expected && before + count >= bench->expected) {
+        xTaskNotifyGive(bench->waiter);
+    }
+}
+
+static void bus_publish_retry(bus_bench_t *bench, uint32_t topic, uint32_t id, uint32_t value)
+{
+    // 生产者优先级高于分发任务，缓冲区满时让出 CPU 等分发任务取走数据
+    while (event_bus_publish(bench->bus, topic, id, value) != ESP_OK) {
+        __atomic_fetch_add(&bench->ring_full, 1, __ATOMIC_RELAXED);
+        vTaskDelay(1);
+    }
+}
+
+static esp_err_t bus_bench_create(bus_bench_t *bench, bench_ctx_t *ctx, uint32_t capacity, uint32_t dispatchers)
+{
+    *bench = (bus_bench_t) {
+        .ctx = ctx,
+        .waiter = xTaskGetCurrentTaskHandle(),
+    };
+    event_bus_config_t config = EVENT_BUS_DEFAULT_CONFIG();
+    config.capacity = capacity;
+    config.max_subscribers = SUBSCRIBERS;
+    config.batch_size = EVENT_BUS_MAX_BATCH;
+    config.dispatcher_count = dispatchers;
+    config.dispatcher_priority = 2;
+    config.dispatcher_stack = TASK_STACK_SIZE;
+    return event_bus_create(&config, &bench->bus);
+}
+
+// ====================== event_bus_publish ======================
+static void publish_count_handler(const event_bus_event_t *events, size_t count, void *ctx)
+{
+    bus_bench_received((bus_bench_t *)ctx, count);
+}
+
+static void publish_producer_task(void *arg)
+{
+    bus_producer_t *producer = (bus_producer_t *)arg;
+    bus_bench_t *bench = producer->bench;
+    uint32_t total = bench_iterations(bench->ctx);
+    for (uint32_t i = producer->index; i < total; i += PRODUCERS) {
+        uint32_t topic = s_topics[i % TOPICS];
+        uint64_t start = bench_now_ns();
+        bus_publish_retry(bench, topic, producer->index, i);
+        if (producer->index == 0) {
+            bench_record_latency(bench->ctx, bench_now_ns() - start);
+        }
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+esp_err_t bench_event_bus_publish(bench_ctx_t *ctx)
+{
+    bus_bench_t bench;
+    esp_err_t ret = bus_bench_create(&bench, ctx, 256, 1);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    bench.expected = bench_iterations(ctx);
+    event_bus_subscribe(bench.bus, EVENT_TOPIC_ALL, publish_count_handler, &bench);
+
+    bus_producer_t producers[PRODUCERS];
+    uint32_t started = 0;
+    for (uint32_t i = 0; i < PRODUCERS; i++) {
+        producers[i] = (bus_producer_t) {
+            .bench = &bench,
+            .index = i,
+        };
+        if (xTaskCreate(publish_producer_task, "BenchPublish", TASK_STACK_SIZE, &producers[i], 3, NULL) != pdPASS) {
+            ret = ESP_ERR_NO_MEM;
+            break;
+        }
+        started++;
+    }
+    // 等生产者全部结束、订阅者收齐所有事件（创建失败时只等已启动的生产者）
+    uint32_t wait = ret == ESP_OK ? started + 1 : started;
+    for (uint32_t done = 0; done < wait;) {
+        done += ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    event_bus_stats_t stats;
+    event_bus_get_stats(bench.bus, &stats);
+    event_bus_delete(bench.bus);
+    if (ret == ESP_OK) {
+        bench_set_metric(ctx, "wakeups_per_event", (double)stats.wakeups / stats.published);
+        bench_set_metric(ctx, "ring_full_waits", bench.ring_full);
+    }
+    return ret;
+}
+
+// ====================== event_bus_delivery ======================
+static void delivery_handler(const event_bus_event_t *events, size_t count, void *ctx)
+{
+    bus_bench_t *bench = (bus_bench_t *)ctx;
+    if (__atomic_exchange_n(&bench->latency_owner, 1, __ATOMIC_ACQUIRE) == 0) {
+        uint32_t now_us = bench_now_us32();
+        for (size_t i = 0; i < count; i++) {
+            bench_record_latency(bench->ctx, (uint64_t)(now_us - events[i].value) * 1000);
+        }
+        __atomic_store_n(&bench->latency_owner, 0, __ATOMIC_RELEASE);
+    }
+    bus_bench_received(bench, count);
+}
+
+static void delivery_producer_task(void *arg)
+{
+    bus_bench_t *bench = (bus_bench_t *)arg;
+    uint32_t total = bench_iterations(bench->ctx);
+    for (uint32_t i = 0; i < total; i++) {
+        bus_publish_retry(bench, s_topics[i % TOPICS], i, bench_now_us32());
+        if ((i + 1) % BURST == 0) {
+            vTaskDelay(1);  // 一次突发结束，生产者阻塞，分发任务开始处理
+        }
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+esp_err_t bench_event_bus_delivery(bench_ctx_t *ctx)
+{
+    bus_bench_t bench;
+    esp_err_t ret = bus_bench_create(&bench, ctx, 64, DISPATCHERS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // 每个主题有 SUBSCRIBERS / TOPICS 个订阅者
+    bench.expected = bench_iterations(ctx) * (SUBSCRIBERS / TOPICS);
+    for (uint32_t i = 0; i < SUBSCRIBERS; i++) {
+        event_bus_subscribe(bench.bus, s_topics[i % TOPICS], delivery_handler, &bench);
+    }
+
+    if (xTaskCreate(delivery_producer_task, "BenchPublish", TASK_STACK_SIZE, &bench, 3, NULL) != pdPASS) {
+        event_bus_delete(bench.bus);
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t done = 0; done < 2;) {
+        done += ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    event_bus_stats_t stats;
+    event_bus_get_stats(bench.bus, &stats);
+    event_bus_delete(bench.bus);
+    bench_set_metric(ctx, "wakeups_per_event", (double)stats.wakeups / stats.published);
+    bench_set_metric(ctx, "events_per_batch", (double)stats.published / stats.batches);
+    bench_set_metric(ctx, "tasks", DISPATCHERS);
+    return ESP_OK;
+}
+
+// ====================== event_queues（改造前） ======================
+typedef struct {
+    bench_ctx_t *ctx;
+    TaskHandle_t waiter;
+    QueueHandle_t queues[SUBSCRIBERS];
+    uint32_t wakeups;
+} queues_bench_t;
+
+typedef struct {
+    queues_bench_t *bench;
+    uint32_t index;
+} queue_subscriber_t;
+
+static void queue_subscriber_task(void *arg)
+{
+    queue_subscriber_t *subscriber = (queue_subscriber_t *)arg;
+    queues_bench_t *bench = subscriber->bench;
+    QueueHandle_t queue = bench->queues[subscriber->index];
+    uint32_t total = bench_iterations(bench->ctx);
+    // 生产者按 i % TOPICS 轮流发布，本订阅者只收自己主题的事件
+    uint32_t topic_index = subscriber->index % TOPICS;
+    uint32_t expected = total > topic_index ? (total - topic_index + TOPICS - 1) / TOPICS : 0;
+    event_bus_event_t event;
+    for (uint32_t count = 0; count < expected; count++) {
+        if (uxQueueMessagesWaiting(queue) == 0) {
+            __atomic_fetch_add(&bench->wakeups, 1, __ATOMIC_RELAXED);  // 队列为空：任务阻塞，之后被唤醒一次
+        }
+        xQueueReceive(queue, &event, portMAX_DELAY);
+        if (subscriber->index == 0) {
+            bench_record_latency(bench->ctx, (uint64_t)(bench_now_us32() - event.value) * 1000);
+        }
+        bench_add_ops(bench->ctx, 1);
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+static void queues_producer_task(void *arg)
+{
+    queues_bench_t *bench = (queues_bench_t *)arg;
+    uint32_t total = bench_iterations(bench->ctx);
+    for (uint32_t i = 0; i < total; i++) {
+        event_bus_event_t event = {
+            .topic = s_topics[i % TOPICS],
+            .id = i,
+            .value = bench_now_us32(),
+        };
+        for (uint32_t s = i % TOPICS; s < SUBSCRIBERS; s += TOPICS) {
+            xQueueSend(bench->queues[s], &event, portMAX_DELAY);
+        }
+        if ((i + 1) % BURST == 0) {
+            vTaskDelay(1);
+        }
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+esp_err_t bench_event_queues(bench_ctx_t *ctx)
+{
+    queues_bench_t bench = {
+        .ctx = ctx,
+        .waiter = xTaskGetCurrentTaskHandle(),
+    };
+    queue_subscriber_t subscribers[SUBSCRIBERS];
+    TaskHandle_t tasks[SUBSCRIBERS] = {0};
+    esp_err_t ret = ESP_OK;
+    for (uint32_t i = 0; i < SUBSCRIBERS && ret == ESP_OK; i++) {
+        subscribers[i] = (queue_subscriber_t) {
+            .bench = &bench,
+            .index = i,
+        };
+        bench.queues[i] = xQueueCreate(QUEUE_LEN, sizeof(event_bus_event_t));
+        if (bench.queues[i] == NULL ||
+            xTaskCreate(queue_subscriber_task, "BenchSubscriber", TASK_STACK_SIZE, &subscribers[i], 2, &tasks[i]) != pdPASS) {
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+    if (ret == ESP_OK && xTaskCreate(queues_producer_task, "BenchPublish", TASK_STACK_SIZE, &bench, 3, NULL) != pdPASS) {
+        ret = ESP_ERR_NO_MEM;
+    }
+
+    if (ret == ESP_OK) {
+        // 等所有订阅者收完、生产者发完
+        for (uint32_t done = 0; done < SUBSCRIBERS + 1;) {
+            done += ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    } else {
+        // 没有生产者，已启动的订阅者都阻塞在空队列上，可以直接删除
+        for (uint32_t i = 0; i < SUBSCRIBERS; i++) {
+            if (tasks[i] != NULL) {
+                vTaskDelete(tasks[i]);
+            }
+        }
+    }
+    for (uint32_t i = 0; i < SUBSCRIBERS; i++) {
+        if (bench.queues[i] != NULL) {
+            vQueueDelete(bench.queues[i]);
+        }
+    }
+    if (ret == ESP_OK) {
+        bench_set_metric(ctx, "wakeups_per_event", (double)bench.wakeups / bench_iterations(ctx));
+        bench_set_metric(ctx, "tasks", SUBSCRIBERS);
+    }
+    return ret;
+}
@@ -0,0 +1,134 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "bench.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include "freertos/timers.h"
+#else
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#endif
+
+/*
+ * 中断交接：与 multitask/isr.h 相同的“中断释放二值信号量 → 任务处理”模式，
+ * 测量从中断发出信号到任务被唤醒的延迟。
+ * 芯片/QEMU 上用 GPTimer 报警中断；linux 目标没有硬件中断，用软件定时器回调模拟。
+ */
+
+#define TASK_STACK_SIZE  4096
+
+typedef struct {
+    bench_ctx_t *ctx;
+    SemaphoreHandle_t semaphore;
+    TaskHandle_t waiter;
+    volatile uint64_t give_ns;  // 中断中释放信号量的时刻
+} isr_bench_t;
+
+// 与 key_interrupt_task 相同：阻塞等待信号量，被唤醒后处理
+static void key_interrupt_task(void *arg)
+{
+    isr_bench_t *bench = (isr_bench_t *)arg;
+    uint32_t total = bench_iterations(bench->ctx);
+    for (uint32_t i = 0; i < total; i++) {
+        xSemaphoreTake(bench->semaphore, portMAX_DELAY);
+        bench_record_latency(bench->ctx, bench_now_ns() - bench->give_ns);
+        bench_add_ops(bench->ctx, 1);
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+static void timer_callback(TimerHandle_t timer)
+{
+    isr_bench_t *bench = (isr_bench_t *)pvTimerGetTimerID(timer);
+    bench->give_ns = bench_now_ns();
+    xSemaphoreGive(bench->semaphore);
+}
+
+esp_err_t bench_isr_handoff(bench_ctx_t *ctx)
+{
+    isr_bench_t bench = {
+        .ctx = ctx,
+        .semaphore = xSemaphoreCreateBinary(),
+        .waiter = xTaskGetCurrentTaskHandle(),
+    };
+    if (bench.semaphore == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    // 每个节拍触发一次（CONFIG_FREERTOS_HZ=1000 时为 1 ms）
+    TimerHandle_t timer = xTimerCreate("BenchISR", 1, pdTRUE, &bench, timer_callback);
+    if (timer == NULL) {
+        vSemaphoreDelete(bench.semaphore);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(key_interrupt_task, "ISRTask", TASK_STACK_SIZE, &bench, 1, NULL) != pdPASS) {
+        xTimerDelete(timer, portMAX_DELAY);
+        vSemaphoreDelete(bench.semaphore);
+        return ESP_ERR_NO_MEM;
+    }
+    xTimerStart(timer, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    xTimerStop(timer, portMAX_DELAY);
+    xTimerDelete(timer, portMAX_DELAY);
+    // 停止/删除命令由定时器服务任务异步处理，等它处理完再释放回调用到的信号量
+    vTaskDelay(pdMS_TO_TICKS(10));
+    vSemaphoreDelete(bench.semaphore);
+    return ESP_OK;
+}
+#else
+static bool IRAM_ATTR alarm_isr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx)
+{
+    isr_bench_t *bench = (isr_bench_t *)user_ctx;
+    BaseType_t high_task_woken = pdFALSE;
+    bench->give_ns = bench_now_ns();
+    xSemaphoreGiveFromISR(bench->semaphore, &high_task_woken);
+    return high_task_woken == pdTRUE;
+}
+
+esp_err_t bench_isr_handoff(bench_ctx_t *ctx)
+{
+    isr_bench_t bench = {
+        .ctx = ctx,
+        .semaphore = xSemaphoreCreateBinary(),
+        .waiter = xTaskGetCurrentTaskHandle(),
+    };
+    if (bench.semaphore == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    gptimer_handle_t timer = NULL;
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,  // 1 MHz，计数单位为微秒
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &timer));
+    gptimer_event_callbacks_t callbacks = { .on_alarm = alarm_isr };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timer, &callbacks, &bench));
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = CONFIG_BENCH_ISR_PERIOD_US,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(timer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_enable(timer));
+
+    if (xTaskCreate(key_interrupt_task, "ISRTask", TASK_STACK_SIZE, &bench, 1, NULL) != pdPASS) {
+        gptimer_disable(timer);
+        gptimer_del_timer(timer);
+        vSemaphoreDelete(bench.semaphore);
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_ERROR_CHECK(gptimer_start(timer));
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    gptimer_stop(timer);
+    gptimer_disable(timer);
+    gptimer_del_timer(timer);
+    vSemaphoreDelete(bench.semaphore);
+    return ESP_OK;
+}
+#endif
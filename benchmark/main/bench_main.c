@@ -0,0 +1,45 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "bench.h"
+
+/*
+ * 基准测试入口：每个负载对应仓库里的一个示例
+ *   queue_pipeline   → multitask（采集任务 → 队列 → 处理任务）
+ *   isr_handoff      → multitask/isr.h、gpio（中断 → 信号量 → 任务）
+ *   logging          → esp_log（ESP_LOGI 格式化与输出）
+ *   pwm_curve        → gpio_pwm（呼吸灯占空比曲线）
+ *   partition_lookup → partition-table（分区查找与遍历）
+ *   wake_*           → gpio、gpio_pwm、touch-element（轮询、忙等与事件驱动的唤醒次数对比）
+ *   overload_*       → multitask（处理任务过载时 sensor_queue 的三种降载策略）
+ *   acq_replay_*     → multitask 的 ADC/回放采集（components/acq，固定速率与不限速）
+ *   telemetry_*      → multitask console_print_task 的汇总输出（文本日志与二进制遥测帧对比）
+ *   event_*          → gpio、multitask/isr.h、touch-element 的事件分发（components/event_bus 与每个订阅者一个任务+队列对比）
+ */
+static const bench_workload_t s_workloads[] = {
+    { "queue_pipeline",   bench_queue_pipeline },
+    { "isr_handoff",      bench_isr_handoff },
+    { "logging",          bench_logging },
+    { "pwm_curve",        bench_pwm_curve },
+    { "partition_lookup", bench_partition_lookup },
+    { "wake_polling",      bench_wake_polling },
+    { "wake_busy_spin",    bench_wake_busy_spin },
+    { "wake_event_driven", bench_wake_event_driven },
+    { "overload_drop_newest", bench_overload_drop_newest },
+    { "overload_drop_oldest", bench_overload_drop_oldest },
+    { "overload_downsample",  bench_overload_downsample },
+    { "acq_replay_rate",      bench_acq_replay_rate },
+    { "acq_replay_max",       bench_acq_replay_max },
+    { "telemetry_text",       bench_telemetry_text },
+    { "telemetry_text_full",  bench_telemetry_text_full },
+    { "telemetry_binary",     bench_telemetry_binary },
+    { "event_bus_publish",    bench_event_bus_publish },
+    { "event_bus_delivery",   bench_event_bus_delivery },
+    { "event_queues",         bench_event_queues },
+};
+
+void app_main(void)
+{
+    // 等待启动日志输出完毕，避免干扰第一个负载
+    vTaskDelay(pdMS_TO_TICKS(100));
+    bench_run_all(s_workloads, sizeof(s_workloads) / sizeof(s_workloads[0]));
+}
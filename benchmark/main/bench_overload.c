@@ -0,0 +1,146 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "flow_ctrl.h"
+#include "bench.h"
+
+/*
+ * 过载压力测试：multitask 流水线（采集任务 → sensor_queue → 处理任务）在处理任务明显变慢时的表现。
+ * 采集任务每个节拍提交 PRODUCER_BURST 个样本，处理任务每个样本耗时 CONSUME_TICKS 个节拍，
+ * 提交速率约为处理能力的 8 倍。与 multitask 的 sensor_collect_task 一样，丢弃类策略下采集周期
+ * 按 flow_ctrl_get_decimation() 拉长（背压时降低采样率），抽取策略下周期不变。分别测试三种降载策略：
+ *   吞吐量         = 处理任务实际取出的样本数 / 秒
+ *   延迟分位数      = 样本在队列中的排队延迟
+ *   drop_rate      = (丢弃 + 抽取) / 提交
+ *   send_max_us    = 单次提交的最长耗时（不应阻塞；改造前队列满时会阻塞 100ms）
+ */
+
+#define TASK_STACK_SIZE       4096
+#define OVERLOAD_DURATION_MS  2000
+#define OVERLOAD_QUEUE_LEN    10     // 与 multitask 的 sensor_queue 相同
+#define PRODUCER_BURST        4      // 每个节拍提交的样本数
+#define CONSUME_TICKS         2      // 处理一个样本的耗时（节拍）
+
+typedef struct {
+    float temperature;
+    float humidity;
+    int sample_id;
+} sensor_data_t;
+
+typedef struct {
+    bench_ctx_t *ctx;
+    flow_ctrl_handle_t flow;
+    flow_shed_policy_t policy;
+    TaskHandle_t waiter;
+    volatile bool running;
+    uint64_t send_max_ns;
+} overload_bench_t;
+
+static void overload_collect_task(void *arg)
+{
+    overload_bench_t *bench = (overload_bench_t *)arg;
+    sensor_data_t data = { 0 };
+    while (bench->running) {
+        for (int i = 0; i < PRODUCER_BURST; i++) {
+            data.temperature = 25.0f + (data.sample_id % 100) / 10.0f;
+            data.humidity = 40.0f + (data.sample_id % 300) / 10.0f;
+            data.sample_id++;
+
+            uint64_t start = bench_now_ns();
+            flow_ctrl_send(bench->flow, &data);
+            uint64_t cost = bench_now_ns() - start;
+            if (cost > bench->send_max_ns) {
+                bench->send_max_ns = cost;
+            }
+        }
+        // 抽取策略由队列抽取样本，采样率不变；丢弃类策略在背压时降低采样率
+        uint32_t period_ticks = 1;
+        if (bench->policy != FLOW_SHED_DOWNSAMPLE) {
+            period_ticks *= flow_ctrl_get_decimation(bench->flow);
+        }
+        vTaskDelay(period_ticks);
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+static void overload_process_task(void *arg)
+{
+    overload_bench_t *bench = (overload_bench_t *)arg;
+    sensor_data_t data;
+    uint32_t latency_us;
+    while (bench->running) {
+        if (!flow_ctrl_receive(bench->flow, &data, pdMS_TO_TICKS(10), &latency_us)) {
+            continue;
+        }
+        bench_record_latency(bench->ctx, (uint64_t)latency_us * 1000);
+        bench_add_ops(bench->ctx, 1);
+        vTaskDelay(CONSUME_TICKS);  // 模拟耗时的处理
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t overload_run(bench_ctx_t *ctx, flow_shed_policy_t policy)
+{
+    overload_bench_t bench = {
+        .ctx = ctx,
+        .policy = policy,
+        .waiter = xTaskGetCurrentTaskHandle(),
+        .running = true,
+    };
+    flow_ctrl_config_t config = {
+        .item_size = sizeof(sensor_data_t),
+        .capacity = OVERLOAD_QUEUE_LEN,
+        .policy = policy,
+    };
+    esp_err_t ret = flow_ctrl_create(&config, &bench.flow);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // 与 multitask 相同：处理任务优先级高于采集任务
+    int created = 0;
+    if (xTaskCreate(overload_process_task, "ProcessTask", TASK_STACK_SIZE, &bench, 2, NULL) == pdPASS) {
+        created++;
+        if (xTaskCreate(overload_collect_task, "CollectTask", TASK_STACK_SIZE, &bench, 1, NULL) == pdPASS) {
+            created++;
+        }
+    }
+    if (created == 2) {
+        vTaskDelay(pdMS_TO_TICKS(OVERLOAD_DURATION_MS));
+    } else {
+        ret = ESP_ERR_NO_MEM;
+    }
+    bench.running = false;
+    for (int i = 0; i < created; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+
+    if (ret == ESP_OK) {
+        flow_ctrl_stats_t stats;
+        flow_ctrl_get_stats(bench.flow, &stats);
+        bench_set_metric(ctx, "offered_per_s", stats.offered * 1000.0 / OVERLOAD_DURATION_MS);
+        bench_set_metric(ctx, "drop_rate", stats.drop_rate);
+        bench_set_metric(ctx, "send_max_us", bench.send_max_ns / 1000.0);
+        flow_ctrl_log_stats(bench.flow, flow_ctrl_policy_name(policy));
+    }
+    flow_ctrl_delete(bench.flow);
+    return ret;
+}
+
+esp_err_t bench_overload_drop_newest(bench_ctx_t *ctx)
+{
+    return overload_run(ctx, FLOW_SHED_DROP_NEWEST);
+}
+
+esp_err_t bench_overload_drop_oldest(bench_ctx_t *ctx)
+{
+    return overload_run(ctx, FLOW_SHED_DROP_OLDEST);
+}
+
+esp_err_t bench_overload_downsample(bench_ctx_t *ctx)
+{
+    return overload_run(ctx, FLOW_SHED_DOWNSAMPLE);
+}
@@ -0,0 +1,31 @@
+#include "esp_partition.h"
+#include "bench.h"
+
+/*
+ * 分区查找：与 partition-table 示例相同，遍历所有 APP 分区，并按名称查找数据分区。
+ * 分区表使用 ../partition-table/partitions.csv（见 sdkconfig.defaults）。
+ */
+
+esp_err_t bench_partition_lookup(bench_ctx_t *ctx)
+{
+    uint32_t total = bench_iterations(ctx);
+    for (uint32_t i = 0; i < total; i++) {
+        uint64_t start = bench_now_ns();
+
+        int app_count = 0;
+        esp_partition_iterator_t iter = esp_partition_find(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, NULL);
+        while (iter != NULL) {
+            app_count++;
+            iter = esp_partition_next(iter);  // 遍历结束时迭代器会被自动释放
+        }
+        const esp_partition_t *assets = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                                 ESP_PARTITION_SUBTYPE_ANY, "assets");
+
+        bench_record_latency(ctx, bench_now_ns() - start);
+        if (app_count == 0 || assets == NULL) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        bench_add_ops(ctx, 1);
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,30 @@
+#include "bench.h"
+
+/*
+ * 呼吸灯曲线：与 gpio_pwm 示例相同的 10 位占空比三角波（0 → 1023 → 0）。
+ * 写入 volatile 变量代替 ledc_set_duty/ledc_update_duty，只测曲线生成与逐级更新的开销。
+ */
+
+#define PWM_RESOLUTION_BITS  10
+
+static volatile uint32_t s_duty_reg;
+
+esp_err_t bench_pwm_curve(bench_ctx_t *ctx)
+{
+    const uint32_t max_duty = (1 << PWM_RESOLUTION_BITS) - 1;
+    uint32_t total = bench_iterations(ctx);
+    for (uint32_t i = 0; i < total; i++) {
+        uint64_t start = bench_now_ns();
+        // 阶段 1：由暗变亮
+        for (uint32_t duty = 0; duty <= max_duty; duty++) {
+            s_duty_reg = duty;
+        }
+        // 阶段 2：由亮变暗
+        for (uint32_t duty = max_duty + 1; duty-- > 0;) {
+            s_duty_reg = duty;
+        }
+        bench_record_latency(ctx, bench_now_ns() - start);
+        bench_add_ops(ctx, 2 * (max_duty + 1));
+    }
+    return ESP_OK;
+}
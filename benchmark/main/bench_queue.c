@@ -0,0 +1,93 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "bench.h"
+
+/*
+ * 队列流水线：与 multitask 示例相同的结构（采集任务 → sensor_queue → 处理任务），
+ * 去掉固定延时，测量满负荷下的吞吐量和单条数据从发送到被处理的延迟。
+ */
+
+#define QUEUE_LEN        10     // 与 multitask 示例一致
+#define TASK_STACK_SIZE  4096
+
+typedef struct {
+    float temperature;
+    float humidity;
+    int sample_id;
+    uint64_t send_ns;  // 发送时刻（用于计算延迟）
+} bench_sensor_data_t;
+
+typedef struct {
+    bench_ctx_t *ctx;
+    QueueHandle_t queue;
+    TaskHandle_t waiter;
+} queue_bench_t;
+
+static void producer_task(void *arg)
+{
+    queue_bench_t *bench = (queue_bench_t *)arg;
+    bench_sensor_data_t data = {0};
+    uint32_t total = bench_iterations(bench->ctx);
+    for (uint32_t i = 0; i < total; i++) {
+        data.temperature = 25.0f + (i % 100) / 10.0f;
+        data.humidity = 40.0f + (i % 300) / 10.0f;
+        data.sample_id = (int)i + 1;
+        data.send_ns = bench_now_ns();
+        xQueueSend(bench->queue, &data, portMAX_DELAY);
+    }
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+static void consumer_task(void *arg)
+{
+    queue_bench_t *bench = (queue_bench_t *)arg;
+    bench_sensor_data_t data;
+    float temp_avg = 0.0f;
+    float humi_avg = 0.0f;
+    uint32_t total = bench_iterations(bench->ctx);
+    for (uint32_t count = 0; count < total; count++) {
+        xQueueReceive(bench->queue, &data, portMAX_DELAY);
+        // 与 data_process_task 相同的滑动平均计算
+        temp_avg = (temp_avg * count + data.temperature) / (count + 1);
+        humi_avg = (humi_avg * count + data.humidity) / (count + 1);
+        bench_record_latency(bench->ctx, bench_now_ns() - data.send_ns);
+        bench_add_ops(bench->ctx, 1);
+    }
+    (void)temp_avg;
+    (void)humi_avg;
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+esp_err_t bench_queue_pipeline(bench_ctx_t *ctx)
+{
+    queue_bench_t bench = {
+        .ctx = ctx,
+        .queue = xQueueCreate(QUEUE_LEN, sizeof(bench_sensor_data_t)),
+        .waiter = xTaskGetCurrentTaskHandle(),
+    };
+    if (bench.queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    // 优先级关系与示例一致：处理任务（2）高于采集任务（1）
+    TaskHandle_t consumer = NULL;
+    if (xTaskCreate(consumer_task, "BenchProcess", TASK_STACK_SIZE, &bench, 2, &consumer) != pdPASS) {
+        vQueueDelete(bench.queue);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(producer_task, "BenchCollect", TASK_STACK_SIZE, &bench, 1, NULL) != pdPASS) {
+        vTaskDelete(consumer); // 消费者还阻塞在空队列上，可以直接删除
+        vQueueDelete(bench.queue);
+        return ESP_ERR_NO_MEM;
+    }
+    // 等两个任务都上报完栈使用量再返回
+    for (uint32_t done = 0; done < 2;) {
+        done += ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    vQueueDelete(bench.queue);
+    return ESP_OK;
+}
@@ -0,0 +1,140 @@
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "telemetry.h"
+#include "bench.h"
+
+/*
+ * 控制台遥测：multitask 示例 console_print_task 每秒一次的汇总，分别以文本日志和二进制遥测帧输出到内存（回环），
+ * 比较每次汇总的编码耗时和字节数。
+ *   telemetry_text      → 现有的五行 ESP_LOGI 文本汇总（只有累计采样与平均温湿度）
+ *   telemetry_text_full → 同样内容的文本加上堆与 3 个任务的信息，与二进制帧携带的内容相同
+ *   telemetry_binary    → telemetry 组件的 COBS 帧（传感器 + 堆 + 3 个任务）；第一次汇总的帧以 BENCH_SAMPLE 输出，
+ *                         由 pytest 用主机解码器校验
+ * 延迟分位数为一次汇总的编码耗时，console_bytes_per_s 为每秒汇总一次时控制台需要传输的字节数。
+ */
+
+static const char *TAG = "MultiTask";
+
+#define SUMMARY_TASKS        3
+#define SAMPLE_CAPTURE_SIZE  (TELEMETRY_MAX_FRAME * 3)
+
+static const float s_temp_avg = 29.9f;
+static const float s_humi_avg = 54.9f;
+
+static size_t s_sink_bytes;
+static uint8_t s_capture[SAMPLE_CAPTURE_SIZE];
+static size_t s_capture_len;
+static bool s_capturing;
+
+static int bench_text_sink(const char *fmt, va_list args)
+{
+    char buf[160];
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    if (len > 0) {
+        s_sink_bytes += (size_t)len;
+    }
+    return len;
+}
+
+static int bench_binary_sink(const void *data, size_t len, void *ctx)
+{
+    if (s_capturing && s_capture_len + len <= sizeof(s_capture)) {
+        memcpy(&s_capture[s_capture_len], data, len);
+        s_capture_len += len;
+    }
+    s_sink_bytes += len;
+    return (int)len;
+}
+
+static void bench_summary_tasks(TaskHandle_t *tasks)
+{
+    // 负载在单个任务中运行，用当前任务代替采集/处理/打印三个任务（两种方式查询开销相同）
+    for (int i = 0; i < SUMMARY_TASKS; i++) {
+        tasks[i] = xTaskGetCurrentTaskHandle();
+    }
+}
+
+/**
+ * @brief  文本汇总
+ * @param  full  true 时在 console_print_task 的五行之后追加堆与任务信息
+ */
+static esp_err_t bench_telemetry_text_run(bench_ctx_t *ctx, bool full)
+{
+    TaskHandle_t tasks[SUMMARY_TASKS];
+    uint32_t total = bench_iterations(ctx);
+    bench_summary_tasks(tasks);
+
+    s_sink_bytes = 0;
+    vprintf_like_t previous = esp_log_set_vprintf(bench_text_sink);
+    for (uint32_t i = 0; i < total; i++) {
+        uint64_t start = bench_now_ns();
+        ESP_LOGI(TAG, "===== 数据汇总 =====");
+        ESP_LOGI(TAG, "累计采样：%d次", (int)i);
+        ESP_LOGI(TAG, "平均温度：%.1f℃", s_temp_avg);
+        ESP_LOGI(TAG, "平均湿度：%.1f%%", s_humi_avg);
+        ESP_LOGI(TAG, "====================");
+        if (full) {
+            ESP_LOGI(TAG, "堆：空闲 %" PRIu32 " 字节，最小 %" PRIu32 " 字节",
+                     esp_get_free_heap_size(), esp_get_minimum_free_heap_size());
+            for (int t = 0; t < SUMMARY_TASKS; t++) {
+                ESP_LOGI(TAG, "任务 %s：优先级 %u，栈剩余 %u", pcTaskGetName(tasks[t]),
+                         (unsigned)uxTaskPriorityGet(tasks[t]), (unsigned)uxTaskGetStackHighWaterMark(tasks[t]));
+            }
+        }
+        bench_record_latency(ctx, bench_now_ns() - start);
+        bench_add_ops(ctx, 1);
+    }
+    esp_log_set_vprintf(previous);
+
+    bench_set_metric(ctx, "console_bytes_per_s", (double)s_sink_bytes / total);
+    return ESP_OK;
+}
+
+esp_err_t bench_telemetry_text(bench_ctx_t *ctx)
+{
+    return bench_telemetry_text_run(ctx, false);
+}
+
+esp_err_t bench_telemetry_text_full(bench_ctx_t *ctx)
+{
+    return bench_telemetry_text_run(ctx, true);
+}
+
+esp_err_t bench_telemetry_binary(bench_ctx_t *ctx)
+{
+    TaskHandle_t tasks[SUMMARY_TASKS];
+    uint32_t total = bench_iterations(ctx);
+    bench_summary_tasks(tasks);
+
+    s_sink_bytes = 0;
+    s_capture_len = 0;
+    telemetry_set_sink(bench_binary_sink, NULL);
+    esp_err_t ret = ESP_OK;
+    for (uint32_t i = 0; i < total && ret == ESP_OK; i++) {
+        s_capturing = (i == 0);
+        uint64_t start = bench_now_ns();
+        ret = telemetry_send_sensor(i, s_temp_avg, s_humi_avg);
+        if (ret == ESP_OK) {
+            ret = telemetry_send_heap();
+        }
+        if (ret == ESP_OK) {
+            ret = telemetry_send_tasks(tasks, SUMMARY_TASKS);
+        }
+        bench_record_latency(ctx, bench_now_ns() - start);
+        bench_add_ops(ctx, 1);
+    }
+    s_capturing = false;
+    telemetry_set_sink(NULL, NULL);
+
+    if (ret == ESP_OK) {
+        bench_report_sample(ctx, s_capture, s_capture_len);
+        bench_set_metric(ctx, "console_bytes_per_s", (double)s_sink_bytes / total);
+    }
+    return ret;
+}
@@ -0,0 +1,388 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "event_bus.h"
+#include "trace.h"
+#include "bench.h"
+
+/*
+ * 唤醒次数：对比 gpio、gpio_pwm、touch-element 三个示例改造前后的 CPU 唤醒次数。
+ *   wake_polling      → 改造前：key_detect_task 每 20ms 读一次按键、pwm_breath_led_task 每 10ms 调一次占空比、
+ *                       led_blink_task 每秒翻转 LED、触摸组件按默认 10ms 处理周期扫描
+ *   wake_busy_spin    → 改造前 gpio 的 key_interrupt_task：不阻塞地反复检查 isPressed 标志
+ *   wake_event_driven → 改造后：按键中断经事件总线分发并启动 20ms 消抖定时器，LED 在定时器回调中翻转，
+ *                       LEDC 硬件渐变每个单程唤醒一次，触摸在回调中处理
+ * linux 目标没有 GPIO/LEDC/触摸驱动，外部事件（按键、触摸）和中断由软件定时器模拟，任务结构与周期同示例一致。
+ * 唤醒次数不由负载自己上报，而是由 components/trace 的任务切换钩子统计：每个核从 IDLE 任务切换到其它任务
+ * 记一次唤醒（开启 tickless idle 后即一次浅睡眠退出），并按切换时间戳得到 IDLE 的时间占比（可以睡眠的时间）。
+ * 操作数为处理的按键事件数，延迟分位数为按键事件从发生到被处理的时间。
+ */
+
+#define TASK_STACK_SIZE         4096
+#define WAKE_TASK_PRIORITY      2
+#define SPIN_TASK_PRIORITY      (tskIDLE_PRIORITY + 1)    // 与 main 任务相同，轮转调度，不会饿死测试流程
+#define WAKE_BENCH_DURATION_MS  2000
+#define KEY_POLL_PERIOD_MS      20                          // key_detect_task 的轮询间隔
+#define BREATH_STEP_MS          10                          // 改造前 pwm_breath_led_task 的步进延时
+#define BREATH_FADE_MS          (1024 * BREATH_STEP_MS)     // 硬件渐变单程时长（与 gpio_pwm 一致）
+#define TOUCH_PROCESS_PERIOD_MS 10                          // TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG 的处理周期
+#define LED_BLINK_PERIOD_MS     1000
+#define KEY_DEBOUNCE_MS         20
+#define KEY_CONFIRM_MS          50                          // key_interrupt_task 的消抖延时
+#define KEY_EVENT_PERIOD_MS     250                         // 模拟按键频率（按下、松开交替）
+#define TOUCH_EVENT_PERIOD_MS   400                         // 模拟触摸频率
+#define WAKE_MAX_TASKS          4
+#define WAKE_KEY_GPIO           4
+#define TIMER_ID_KEY_DEBOUNCE   2
+
+typedef enum {
+    WAKE_MODE_POLLING = 0,
+    WAKE_MODE_BUSY_SPIN,
+    WAKE_MODE_EVENT_DRIVEN,
+} wake_mode_t;
+
+typedef struct {
+    bench_ctx_t *ctx;
+    TaskHandle_t waiter;
+    TaskHandle_t breath_task;
+    event_bus_handle_t bus;             // 仅事件驱动方式使用
+    TimerHandle_t debounce_timer;
+    volatile uint32_t key_level;        // 模拟的按键引脚电平（0：按下，1：松开）
+    volatile uint64_t key_event_ns;     // 最近一次电平变化的时刻
+    volatile bool key_pressed;          // 模拟 gpio 的 isPressed 标志
+    volatile uint32_t touch_pending;    // 未处理的触摸事件数
+    uint32_t touch_handled;
+    uint32_t last_key_level;
+    uint32_t led_level;
+    volatile bool running;
+} wake_bench_t;
+
+static void wake_task_exit(wake_bench_t *bench)
+{
+    bench_report_stack(bench->ctx, TASK_STACK_SIZE);
+    xTaskNotifyGive(bench->waiter);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief  读取按键电平，电平变化时记录从按键到被处理的延迟
+ */
+static void wake_handle_key(wake_bench_t *bench)
+{
+    uint32_t key_level = bench->key_level;
+    if (key_level != bench->last_key_level) {
+        bench->last_key_level = key_level;
+        bench_add_ops(bench->ctx, 1);
+        bench_record_latency(bench->ctx, bench_now_ns() - bench->key_event_ns);
+    }
+}
+
+// ====================== 模拟外部事件（中断） ======================
+static void key_event_callback(TimerHandle_t timer)
+{
+    wake_bench_t *bench = (wake_bench_t *)pvTimerGetTimerID(timer);
+    bench->key_event_ns = bench_now_ns();
+    bench->key_level = !bench->key_level;
+    if (bench->key_level == 0) {
+        bench->key_pressed = true;
+    }
+    if (bench->bus != NULL) {
+        event_bus_publish(bench->bus, EVENT_TOPIC_GPIO, WAKE_KEY_GPIO, bench->key_level);
+    }
+}
+
+static void touch_event_callback(TimerHandle_t timer)
+{
+    wake_bench_t *bench = (wake_bench_t *)pvTimerGetTimerID(timer);
+    if (bench->bus != NULL) {
+        // 改造后触摸在组件回调中直接处理
+        bench->touch_handled++;
+    } else {
+        bench->touch_pending++;
+    }
+}
+
+// ====================== 改造前：周期轮询 ======================
+static void key_detect_task(void *arg)
+{
+    wake_bench_t *bench = (wake_bench_t *)arg;
+    while (bench->running) {
+        wake_handle_key(bench);
+        vTaskDelay(pdMS_TO_TICKS(KEY_POLL_PERIOD_MS));
+    }
+    wake_task_exit(bench);
+}
+
+static void breath_step_task(void *arg)
+{
+    wake_bench_t *bench = (wake_bench_t *)arg;
+    while (bench->running) {
+        vTaskDelay(pdMS_TO_TICKS(BREATH_STEP_MS));
+    }
+    wake_task_exit(bench);
+}
+
+static void touch_process_task(void *arg)
+{
+    wake_bench_t *bench = (wake_bench_t *)arg;
+    while (bench->running) {
+        vTaskDelay(pdMS_TO_TICKS(TOUCH_PROCESS_PERIOD_MS));
+        if (bench->touch_pending != 0) {
+            bench->touch_handled += bench->touch_pending;
+            bench->touch_pending = 0;
+        }
+    }
+    wake_task_exit(bench);
+}
+
+static void led_blink_task(void *arg)
+{
+    wake_bench_t *bench = (wake_bench_t *)arg;
+    while (bench->running) {
+        bench->led_level = !bench->led_level;
+        vTaskDelay(pdMS_TO_TICKS(LED_BLINK_PERIOD_MS));
+    }
+    wake_task_exit(bench);
+}
+
+/**
+ * @brief  gpio 改造前的 key_interrupt_task：没有按键时不阻塞，一直检查标志
+ * @note   原代码没有清除 isPressed（第一次按键后就变成每 50ms 一次的轮询），这里按其意图处理后清除
+ */
+static void key_spin_task(void *arg)
+{
+    wake_bench_t *bench = (wake_bench_t *)arg;
+    while (bench->running) {
+        if (bench->key_pressed) {
+            bench->key_pressed = false;
+            vTaskDelay(pdMS_TO_TICKS(KEY_CONFIRM_MS));
+            wake_handle_key(bench);
+        }
+    }
+    wake_task_exit(bench);
+}
+
+// ====================== 改造后：事件驱动 ======================
+static void debounce_timer_callback(TimerHandle_t timer)
+{
+    wake_bench_t *bench = (wake_bench_t *)pvTimerGetTimerID(timer);
+    event_bus_publish(bench->bus, EVENT_TOPIC_TIMER, TIMER_ID_KEY_DEBOUNCE, 0);
+}
+
+static void led_timer_callback(TimerHandle_t timer)
+{
+    wake_bench_t *bench = (wake_bench_t *)pvTimerGetTimerID(timer);
+    bench->led_level = !bench->led_level;
+}
+
+/**
+ * @brief  同 gpio 的 key_level_event_handler：GPIO 事件启动消抖定时器，定时器事件中读取电平
+ */
+static void key_event_handler(const event_bus_event_t *events, size_t count, void *ctx)
+{
+    wake_bench_t *bench = (wake_bench_t *)ctx;
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].topic == EVENT_TOPIC_GPIO) {
+            xTimerReset(bench->debounce_timer, 0);
+        } else if (events[i].id == TIMER_ID_KEY_DEBOUNCE) {
+            wake_handle_key(bench);
+        }
+    }
+}
+
+static void breath_fade_task(void *arg)
+{
+    wake_bench_t *bench = (wake_bench_t *)arg;
+    while (1) {
+        // 等待硬件渐变完成；结束测试时由通知提前唤醒
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BREATH_FADE_MS)) != 0 || !bench->running) {
+            break;
+        }
+    }
+    wake_task_exit(bench);
+}
+
+// ====================== 唤醒统计（任务切换钩子） ======================
+typedef struct {
+    TaskHandle_t idle[CONFIG_FREERTOS_NUMBER_OF_CORES];
+    uint32_t wakeups;       // 从 IDLE 切换到其它任务的次数（各核合计）
+    uint64_t idle_ts;       // IDLE 运行时间（时间戳单位，各核合计）
+    uint64_t window_ts;     // 记录窗口（各核合计）
+    uint32_t lost;
+    int core;               // 正在遍历的核
+    bool in_idle;
+    uint32_t last_ts;
+} wake_count_t;
+
+static void wake_count_visit(const trace_core_info_t *core, const trace_event_t *event, void *ctx)
+{
+    wake_count_t *count = (wake_count_t *)ctx;
+    if (count->core != core->core) {
+        // 记录开始时本核运行的是测试流程或 IPC 任务，不是 IDLE
+        count->core = core->core;
+        count->in_idle = false;
+        count->last_ts = core->start_ts;
+    }
+
+    if (event == NULL) {
+        if (count->in_idle) {
+            count->idle_ts += core->end_ts - count->last_ts;
+        }
+        count->window_ts += core->end_ts - core->start_ts;
+        count->lost += core->lost;
+        return;
+    }
+    if (event->type != TRACE_EVT_TASK_SWITCH_IN) {
+        return;
+    }
+    bool idle = event->id == TRACE_ID(count->idle[core->core]);
+    int32_t delta = (int32_t)(event->ts - count->last_ts);
+    if (delta > 0) {
+        if (count->in_idle) {
+            count->idle_ts += (uint32_t)delta;
+        }
+        count->last_ts = event->ts;
+    }
+    if (count->in_idle && !idle) {
+        count->wakeups++;
+    }
+    count->in_idle = idle;
+}
+
+// ====================== 公共流程 ======================
+static esp_err_t wake_bench_run(bench_ctx_t *ctx, wake_mode_t mode)
+{
+    wake_bench_t bench = {
+        .ctx = ctx,
+        .waiter = xTaskGetCurrentTaskHandle(),
+        .key_level = 1,
+        .last_key_level = 1,
+        .running = true,
+    };
+    TaskFunction_t tasks[WAKE_MAX_TASKS] = { NULL };
+    UBaseType_t priority = WAKE_TASK_PRIORITY;
+    TimerHandle_t led_timer = NULL;
+    esp_err_t ret = ESP_OK;
+    switch (mode) {
+    case WAKE_MODE_POLLING:
+        tasks[0] = key_detect_task;
+        tasks[1] = breath_step_task;
+        tasks[2] = touch_process_task;
+        tasks[3] = led_blink_task;
+        break;
+    case WAKE_MODE_BUSY_SPIN:
+        tasks[0] = key_spin_task;
+        priority = SPIN_TASK_PRIORITY;
+        break;
+    case WAKE_MODE_EVENT_DRIVEN: {
+        tasks[0] = breath_fade_task;
+        event_bus_config_t config = EVENT_BUS_DEFAULT_CONFIG();
+        config.capacity = 16;
+        config.dispatcher_priority = WAKE_TASK_PRIORITY;
+        ret = event_bus_create(&config, &bench.bus);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        bench.debounce_timer = xTimerCreate("KeyDebounce", pdMS_TO_TICKS(KEY_DEBOUNCE_MS), pdFALSE,
+                                            &bench, debounce_timer_callback);
+        led_timer = xTimerCreate("LedBlink", pdMS_TO_TICKS(LED_BLINK_PERIOD_MS), pdTRUE,
+                                 &bench, led_timer_callback);
+        if (bench.debounce_timer == NULL || led_timer == NULL) {
+            ret = ESP_ERR_NO_MEM;
+        } else {
+            ret = event_bus_subscribe(bench.bus, EVENT_TOPIC_GPIO | EVENT_TOPIC_TIMER, key_event_handler, &bench);
+        }
+        break;
+    }
+    }
+
+    TimerHandle_t key_timer = xTimerCreate("KeyEvt", pdMS_TO_TICKS(KEY_EVENT_PERIOD_MS), pdTRUE,
+                                           &bench, key_event_callback);
+    TimerHandle_t touch_timer = xTimerCreate("TouchEvt", pdMS_TO_TICKS(TOUCH_EVENT_PERIOD_MS), pdTRUE,
+                                             &bench, touch_event_callback);
+    if (ret == ESP_OK && (key_timer == NULL || touch_timer == NULL)) {
+        ret = ESP_ERR_NO_MEM;
+    }
+
+    int created = 0;
+    for (int i = 0; i < WAKE_MAX_TASKS && tasks[i] != NULL && ret == ESP_OK; i++) {
+        TaskHandle_t handle = NULL;
+        if (xTaskCreate(tasks[i], "WakeTask", TASK_STACK_SIZE, &bench, priority, &handle) != pdPASS) {
+            ret = ESP_ERR_NO_MEM;
+            break;
+        }
+        if (tasks[i] == breath_fade_task) {
+            bench.breath_task = handle;
+        }
+        created++;
+    }
+
+    wake_count_t count = { .core = -1 };
+    uint64_t elapsed_ns = 0;
+    if (ret == ESP_OK) {
+        for (int core = 0; core < CONFIG_FREERTOS_NUMBER_OF_CORES; core++) {
+            count.idle[core] = xTaskGetIdleTaskHandleForCore(core);
+        }
+        xTimerStart(key_timer, portMAX_DELAY);
+        xTimerStart(touch_timer, portMAX_DELAY);
+        if (led_timer != NULL) {
+            xTimerStart(led_timer, portMAX_DELAY);
+        }
+        // 只统计稳定运行的窗口，不含任务创建与退出
+        uint64_t start_ns = bench_now_ns();
+        trace_start();
+        vTaskDelay(pdMS_TO_TICKS(WAKE_BENCH_DURATION_MS));
+        ret = trace_visit(wake_count_visit, &count);
+        elapsed_ns = bench_now_ns() - start_ns;
+        if (ret == ESP_OK && count.lost != 0) {
+            ret = ESP_ERR_INVALID_SIZE;  // 缓冲区被覆盖，唤醒次数不完整，需要增大 CONFIG_TRACE_BUFFER_EVENTS
+        }
+    }
+
+    // 先删除模拟外部事件的定时器，再通知已创建的任务退出
+    TimerHandle_t timers[] = { key_timer, touch_timer, led_timer };
+    for (size_t i = 0; i < sizeof(timers) / sizeof(timers[0]); i++) {
+        if (timers[i] != NULL) {
+            xTimerDelete(timers[i], portMAX_DELAY);
+        }
+    }
+    bench.running = false;
+    if (bench.breath_task != NULL) {
+        xTaskNotifyGive(bench.breath_task);
+    }
+    for (int i = 0; i < created; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+    // 删除命令由定时器服务任务异步处理；分发任务会重启消抖定时器、消抖定时器又会发布事件，
+    // 等删除命令处理完、最后一次消抖也到期后，再删除事件总线和消抖定时器
+    vTaskDelay(pdMS_TO_TICKS(KEY_DEBOUNCE_MS + 10));
+    if (bench.bus != NULL) {
+        event_bus_delete(bench.bus);
+    }
+    if (bench.debounce_timer != NULL) {
+        xTimerDelete(bench.debounce_timer, portMAX_DELAY);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    double elapsed_s = elapsed_ns / 1e9;
+    bench_set_metric(ctx, "wakeups_per_s", elapsed_s > 0 ? count.wakeups / elapsed_s : 0.0);
+    bench_set_metric(ctx, "idle_pct", count.window_ts > 0 ? 100.0 * count.idle_ts / count.window_ts : 0.0);
+    return ESP_OK;
+}
+
+esp_err_t bench_wake_polling(bench_ctx_t *ctx)
+{
+    return wake_bench_run(ctx, WAKE_MODE_POLLING);
+}
+
+esp_err_t bench_wake_busy_spin(bench_ctx_t *ctx)
+{
+    return wake_bench_run(ctx, WAKE_MODE_BUSY_SPIN);
+}
+
+esp_err_t bench_wake_event_driven(bench_ctx_t *ctx)
+{
+    return wake_bench_run(ctx, WAKE_MODE_EVENT_DRIVEN);
+}
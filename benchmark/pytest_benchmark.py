@@ -0,0 +1,224 @@
+# SPDX-License-Identifier: CC0-1.0
+import json
+import logging
+import os
+import sys
+from typing import Dict, List, Tuple
+
+import pytest
+from pytest_embedded_idf.dut import IdfDut
+from pytest_embedded_idf.utils import idf_parametrize
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', 'components', 'telemetry', 'tools'))
+import telemetry_decode  # noqa: E402
+
+BASELINE_FILE = os.path.join(os.path.dirname(__file__), 'baseline.json')
+
+# 越大越好的指标，其余指标越小越好
+HIGHER_IS_BETTER = {'throughput_ops_s', 'idle_pct'}
+
+# 事件驱动相对轮询至少减少的唤醒倍数
+WAKEUP_REDUCTION_MIN = 5
+# 忙等（改造前的 key_interrupt_task）占满一个核，IDLE 时间占比至少比事件驱动低的百分点
+BUSY_SPIN_IDLE_LOSS_MIN = 40
+
+# 过载测试：处理任务每个样本耗时 2 个节拍（CONFIG_FREERTOS_HZ=1000 时处理能力约 500 个/秒）
+OVERLOAD_THROUGHPUT_MIN = 250
+# 单次提交的最长耗时（微秒）：提交不应阻塞，留出主机调度抖动的余量
+OVERLOAD_SEND_MAX_US = 5000
+
+# 高速采集：回放速率（帧/秒，与 bench_acq.c 中的 ACQ_FRAME_RATE_HZ 一致）及持续速率至少达到的比例
+ACQ_FRAME_RATE_HZ = 20000
+ACQ_RATE_MIN_RATIO = 0.95
+
+# 二进制遥测相对内容相同的文本日志（telemetry_text_full）至少减少的字节倍数
+TELEMETRY_BYTES_REDUCTION_MIN = 3
+
+# 事件总线批量分发相对每个订阅者一个任务+队列，消费侧唤醒次数至少减少的倍数
+EVENT_BUS_WAKEUP_REDUCTION_MIN = 2
+
+
+def collect_results(dut: IdfDut, timeout: int) -> Dict[str, dict]:
+    """读取所有 BENCH_RESULT 行，直到 BENCH_DONE（BENCH_SAMPLE 数据以 sample_hex 附加到对应负载的结果中）"""
+    results: Dict[str, dict] = {}
+    samples: Dict[str, str] = {}
+    while True:
+        match = dut.expect(r'BENCH_RESULT (\{.*\})|BENCH_SAMPLE (\w+) ([0-9a-f]+)|BENCH_DONE (\w+)',
+                           timeout=timeout)
+        if match.group(4) is not None:
+            assert match.group(4).decode() == 'OK', '有负载执行失败，见上方日志'
+            return results
+        if match.group(2) is not None:
+            samples[match.group(2).decode()] = match.group(3).decode()
+            continue
+        result = json.loads(match.group(1).decode())
+        if result['name'] in samples:
+            result['sample_hex'] = samples.pop(result['name'])
+        results[result['name']] = result
+
+
+def compare(target: str, results: Dict[str, dict]) -> Tuple[List[str], List[str]]:
+    """与基线对比，返回（超出容差的回退项，缺少基线的负载或指标）；只比较基线中实际存在的指标"""
+    with open(BASELINE_FILE, encoding='utf-8') as f:
+        baseline = json.load(f)
+    tolerance: Dict[str, float] = baseline['tolerance']
+    expected: Dict[str, dict] = baseline['targets'].get(target, {})
+
+    regressions = []
+    missing = []
+    for name, result in results.items():
+        if name not in expected:
+            missing.append(name)
+            continue
+        for metric, limit in tolerance.items():
+            if metric not in result:
+                continue
+            base = expected[name].get(metric)
+            if base is None:
+                missing.append(f'{name}.{metric}')
+                continue
+            if base == 0:
+                continue  # 基线为 0（例如没有堆分配）时无法按比例比较
+            change = (result[metric] - base) / base
+            if metric in HIGHER_IS_BETTER:
+                change = -change
+            if change > limit:
+                regressions.append(f'{name}.{metric}: {result[metric]} vs 基线 {base}（退化 {change:.0%}，容差 {limit:.0%}）')
+    return regressions, missing
+
+
+def check_wakeups(results: Dict[str, dict]) -> None:
+    """事件驱动方式的唤醒次数必须明显低于轮询方式，忙等方式几乎没有可以睡眠的时间（与基线无关，每次都检查）"""
+    polling = results.get('wake_polling')
+    busy_spin = results.get('wake_busy_spin')
+    event_driven = results.get('wake_event_driven')
+    if polling is None or busy_spin is None or event_driven is None:
+        return
+    for name, result in (('轮询', polling), ('忙等', busy_spin), ('事件驱动', event_driven)):
+        logging.info(f'唤醒次数：{name} {result["wakeups_per_s"]}/s，IDLE 占比 {result["idle_pct"]:.1f}%')
+    assert event_driven['wakeups_per_s'] * WAKEUP_REDUCTION_MIN < polling['wakeups_per_s'], \
+        f'事件驱动唤醒次数 {event_driven["wakeups_per_s"]}/s 未低于轮询 {polling["wakeups_per_s"]}/s 的 1/{WAKEUP_REDUCTION_MIN}'
+    assert busy_spin['idle_pct'] + BUSY_SPIN_IDLE_LOSS_MIN < event_driven['idle_pct'], \
+        f'忙等 IDLE 占比 {busy_spin["idle_pct"]:.1f}% 与事件驱动 {event_driven["idle_pct"]:.1f}% 相差不到 {BUSY_SPIN_IDLE_LOSS_MIN} 个百分点'
+
+
+def check_overload(results: Dict[str, dict]) -> None:
+    """过载时生产者不阻塞、有降载发生，处理任务仍保持接近满负荷的吞吐量"""
+    for name, result in results.items():
+        if not name.startswith('overload_'):
+            continue
+        logging.info(f'{name}：吞吐 {result["throughput_ops_s"]}/s，提交 {result["offered_per_s"]}/s，'
+                     f'丢弃率 {result["drop_rate"]:.1%}，p99 排队延迟 {result["p99_us"]} us')
+        assert result['drop_rate'] > 0, f'{name} 没有发生降载，负载不足以过载'
+        assert result['send_max_us'] < OVERLOAD_SEND_MAX_US, f'{name} 提交阻塞了 {result["send_max_us"]} us'
+        assert result['throughput_ops_s'] > OVERLOAD_THROUGHPUT_MIN, f'{name} 过载时吞吐量过低'
+
+
+def check_acq(results: Dict[str, dict]) -> None:
+    """固定速率回放时持续跟上且不丢帧，不限速回放的最大帧率高于目标速率（留有余量）"""
+    rate = results.get('acq_replay_rate')
+    peak = results.get('acq_replay_max')
+    if rate is None or peak is None:
+        return
+    logging.info(f'高速采集：目标 {ACQ_FRAME_RATE_HZ} 帧/s，实际 {rate["frame_rate_hz"]} 帧/s，'
+                 f'CPU 占用 {rate["cpu_load"]:.1%}，最大 {peak["frame_rate_hz"]} 帧/s')
+    assert rate['frame_rate_hz'] >= ACQ_FRAME_RATE_HZ * ACQ_RATE_MIN_RATIO, \
+        f'采集速率 {rate["frame_rate_hz"]} 帧/s 跟不上目标 {ACQ_FRAME_RATE_HZ} 帧/s'
+    assert rate['overrun_frames'] == 0, f'目标速率下丢了 {rate["overrun_frames"]} 帧'
+    assert peak['frame_rate_hz'] > ACQ_FRAME_RATE_HZ, f'最大采集速率 {peak["frame_rate_hz"]} 帧/s 没有余量'
+
+
+def check_telemetry(results: Dict[str, dict]) -> None:
+    """回环校验：二进制帧能被主机解码器还原；字节数、编码耗时都低于内容相同的文本，字节数也低于现有的五行文本汇总"""
+    text = results.get('telemetry_text')
+    text_full = results.get('telemetry_text_full')
+    binary = results.get('telemetry_binary')
+    if text is None or text_full is None or binary is None:
+        return
+    for name, result in (('现有文本', text), ('完整文本', text_full), ('二进制', binary)):
+        logging.info(f'控制台汇总：{name} {result["console_bytes_per_s"]:.0f} B/s、编码 p50 {result["p50_us"]} us')
+
+    messages, garbage = telemetry_decode.decode_stream(bytes.fromhex(binary['sample_hex']))
+    assert not garbage, f'遥测帧之外有多余数据：{garbage!r}'
+    assert [m.name for m in messages] == ['sensor', 'heap', 'tasks']
+    assert [m.seq for m in messages] == [(messages[0].seq + i) & 0xFFFF for i in range(3)]
+    sensor = messages[0].fields
+    assert sensor['sample_count'] == 0
+    assert abs(sensor['temp_avg'] - 29.9) < 1e-3 and abs(sensor['humi_avg'] - 54.9) < 1e-3
+    assert len(messages[2].fields['tasks']) == 3
+
+    assert binary['console_bytes_per_s'] * TELEMETRY_BYTES_REDUCTION_MIN < text_full['console_bytes_per_s'], \
+        '二进制遥测的字节数没有明显少于内容相同的文本日志'
+    assert binary['p50_us'] < text_full['p50_us'], '二进制遥测的编码耗时不低于内容相同的文本日志'
+    assert binary['console_bytes_per_s'] < text['console_bytes_per_s'], \
+        '二进制遥测（含堆与任务信息）的字节数不低于现有的五行文本汇总'
+
+
+def check_event_bus(results: Dict[str, dict]) -> None:
+    """事件总线用更少的任务、更少的堆完成同样的分发，且消费侧唤醒次数明显减少"""
+    bus = results.get('event_bus_delivery')
+    queues = results.get('event_queues')
+    if bus is None or queues is None:
+        return
+    publish = results.get('event_bus_publish')
+    if publish is not None:
+        logging.info(f'事件发布：p50 {publish["p50_us"]} us、p99 {publish["p99_us"]} us，缓冲区满等待 {publish["ring_full_waits"]} 次')
+    logging.info(f'事件分发：总线 {bus["tasks"]} 个任务、堆 {bus["heap_peak_bytes"]} B、每事件唤醒 {bus["wakeups_per_event"]:.3f} 次'
+                 f'（每批 {bus["events_per_batch"]:.1f} 个）；队列 {queues["tasks"]} 个任务、堆 {queues["heap_peak_bytes"]} B、'
+                 f'每事件唤醒 {queues["wakeups_per_event"]:.3f} 次')
+    assert bus['ops'] == queues['ops'], f'交付的事件数不一致：总线 {bus["ops"]}，队列 {queues["ops"]}'
+    assert bus['tasks'] < queues['tasks']
+    assert bus['heap_peak_bytes'] < queues['heap_peak_bytes'], '事件总线的堆占用没有低于每个订阅者一个队列'
+    assert bus['wakeups_per_event'] * EVENT_BUS_WAKEUP_REDUCTION_MIN < queues['wakeups_per_event'], \
+        f'事件总线每事件唤醒 {bus["wakeups_per_event"]:.3f} 次，未低于队列方式的 1/{EVENT_BUS_WAKEUP_REDUCTION_MIN}'
+
+
+def update_baseline(target: str, results: Dict[str, dict]) -> None:
+    with open(BASELINE_FILE, encoding='utf-8') as f:
+        baseline = json.load(f)
+    baseline['targets'][target] = {
+        name: {metric: result[metric] for metric in baseline['tolerance'] if metric in result}
+        for name, result in sorted(results.items())
+    }
+    with open(BASELINE_FILE, 'w', encoding='utf-8') as f:
+        json.dump(baseline, f, indent=4, ensure_ascii=False)
+        f.write('\n')
+
+
+def run_benchmark(dut: IdfDut, target: str, timeout: int) -> None:
+    results = collect_results(dut, timeout)
+    with open(os.path.join(dut.logdir, f'bench_{target}.json'), 'w', encoding='utf-8') as f:
+        json.dump(results, f, indent=2)
+    for name, result in results.items():
+        logging.info(f'{name}: {json.dumps(result)}')
+    check_wakeups(results)
+    check_overload(results)
+    check_acq(results)
+    check_telemetry(results)
+    check_event_bus(results)
+
+    # BENCH_UPDATE_BASELINE=1 时用本次结果覆盖基线（在参考机器上运行后提交 baseline.json）
+    if os.getenv('BENCH_UPDATE_BASELINE') == '1':
+        update_baseline(target, results)
+        return
+
+    regressions, missing = compare(target, results)
+    if missing:
+        logging.warning(f'目标 {target} 缺少以下基线，未做回退比较（在参考机器上用 BENCH_UPDATE_BASELINE=1 生成后提交）：'
+                        + '、'.join(missing))
+    assert not regressions, '性能回退：\n' + '\n'.join(regressions)
+    if all(name in missing for name in results):
+        pytest.skip(f'目标 {target} 没有基线，只执行了与基线无关的检查')
+
+
+@pytest.mark.host_test
+@idf_parametrize('target', ['linux'], indirect=['target'])
+def test_benchmark_linux(dut: IdfDut) -> None:
+    run_benchmark(dut, 'linux', timeout=120)
+
+
+@pytest.mark.host_test
+@pytest.mark.qemu
+@idf_parametrize('target', ['esp32s3'], indirect=['target'])
+def test_benchmark_qemu(dut: IdfDut) -> None:
+    run_benchmark(dut, 'esp32s3', timeout=600)
@@ -0,0 +1,260 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "acq.h"
+#include "acq_source.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_attr.h"
+#include "esp_timer.h"
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+static const char *TAG = "acq";
+
+struct acq {
+    acq_config_t config;
+    uint8_t channels[ACQ_MAX_CHANNELS];
+    acq_source_t *source;
+    bool running;
+
+    acq_block_t *blocks;
+    uint16_t *raw_storage;        // block_count * block_frames * channel_count
+    uint8_t *item_storage;        // block_count * block_frames * item_size
+    QueueHandle_t free_queue;     // 空闲块指针
+    QueueHandle_t ready_queue;    // 装满待处理的块指针
+
+    // 以下状态只由数据源（acq_push）修改
+    acq_block_t *filling;         // 正在填充的块（NULL 表示还没取到空闲块）
+    uint16_t *frame_ptr;          // 当前帧的写入位置
+    uint32_t fill_frames;
+    uint8_t frame_pos;            // 当前帧已写入的通道数
+    uint32_t next_seq;
+    uint16_t discard_frame[ACQ_MAX_CHANNELS]; // 没有空闲块时当前帧写到这里后丢弃
+
+    acq_stats_t stats;
+};
+
+#if CONFIG_IDF_TARGET_LINUX
+static int64_t acq_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#else
+#define acq_now_us()  esp_timer_get_time()
+#endif
+
+#define ACQ_STAT_ADD(acq, field, n)  __atomic_fetch_add(&(acq)->stats.field, (n), __ATOMIC_RELAXED)
+
+static inline uint16_t *acq_block_raw(struct acq *acq, const acq_block_t *block)
+{
+    return acq->raw_storage + (size_t)(block - acq->blocks) * acq->config.block_frames * acq->config.channel_count;
+}
+
+esp_err_t acq_create(const acq_config_t *config, acq_source_t *source, acq_handle_t *ret_handle)
+{
+    if (config == NULL || source == NULL || ret_handle == NULL || config->channels == NULL ||
+        config->channel_count == 0 || config->channel_count > ACQ_MAX_CHANNELS || config->item_size == 0 ||
+        config->block_frames == 0 || config->block_count < 2 || config->decode == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct acq *acq = calloc(1, sizeof(*acq));
+    if (acq == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    acq->config = *config;
+    memcpy(acq->channels, config->channels, config->channel_count);
+    acq->config.channels = acq->channels;
+    acq->source = source;
+
+    size_t frames = (size_t)config->block_count * config->block_frames;
+    acq->blocks = calloc(config->block_count, sizeof(acq_block_t));
+    acq->raw_storage = malloc(frames * config->channel_count * sizeof(uint16_t));
+    acq->item_storage = malloc(frames * config->item_size);
+    acq->free_queue = xQueueCreate(config->block_count, sizeof(acq_block_t *));
+    acq->ready_queue = xQueueCreate(config->block_count, sizeof(acq_block_t *));
+    if (acq->blocks == NULL || acq->raw_storage == NULL || acq->item_storage == NULL ||
+        acq->free_queue == NULL || acq->ready_queue == NULL) {
+        acq->source = NULL;  // 创建失败时数据源仍归调用者所有
+        acq_delete(acq);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint32_t i = 0; i < config->block_count; i++) {
+        acq_block_t *block = &acq->blocks[i];
+        block->items = acq->item_storage + (size_t)i * config->block_frames * config->item_size;
+        block->raw = acq_block_raw(acq, block);
+        xQueueSend(acq->free_queue, &block, 0);
+    }
+
+    ESP_LOGD(TAG, "%u 个通道，%" PRIu32 " 块 × %" PRIu32 " 帧", config->channel_count,
+             config->block_count, config->block_frames);
+    *ret_handle = acq;
+    return ESP_OK;
+}
+
+esp_err_t acq_start(acq_handle_t acq)
+{
+    if (acq->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // 数据源停止时才会走到这里，可以安全地重置拼帧状态
+    acq->frame_pos = 0;
+    esp_err_t ret = acq->source->start(acq->source, acq);
+    if (ret == ESP_OK) {
+        acq->running = true;
+    }
+    return ret;
+}
+
+esp_err_t acq_stop(acq_handle_t acq)
+{
+    if (!acq->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = acq->source->stop(acq->source);
+    if (ret == ESP_OK) {
+        acq->running = false;
+    }
+    return ret;
+}
+
+void acq_delete(acq_handle_t acq)
+{
+    if (acq == NULL) {
+        return;
+    }
+    if (acq->running) {
+        acq_stop(acq);
+    }
+    if (acq->source != NULL) {
+        acq->source->del(acq->source);
+    }
+    if (acq->free_queue != NULL) {
+        vQueueDelete(acq->free_queue);
+    }
+    if (acq->ready_queue != NULL) {
+        vQueueDelete(acq->ready_queue);
+    }
+    free(acq->blocks);
+    free(acq->raw_storage);
+    free(acq->item_storage);
+    free(acq);
+}
+
+// ====================== 数据源侧（可在中断中执行） ======================
+static IRAM_ATTR bool acq_take_free_block(struct acq *acq, bool from_isr)
+{
+    acq_block_t *block = NULL;
+    BaseType_t ok = from_isr ? xQueueReceiveFromISR(acq->free_queue, &block, NULL)
+                             : xQueueReceive(acq->free_queue, &block, 0);
+    if (ok != pdPASS) {
+        return false;
+    }
+    acq->filling = block;
+    acq->fill_frames = 0;
+    return true;
+}
+
+static IRAM_ATTR bool acq_post_block(struct acq *acq, bool from_isr)
+{
+    acq_block_t *block = acq->filling;
+    BaseType_t high_task_woken = pdFALSE;
+    block->frames = acq->fill_frames;
+    block->seq = acq->next_seq++;
+    block->timestamp_us = acq_now_us();
+    acq->filling = NULL;
+    // 就绪队列与空闲队列长度相同，块总数固定，这里不会失败
+    if (from_isr) {
+        xQueueSendFromISR(acq->ready_queue, &block, &high_task_woken);
+    } else {
+        xQueueSend(acq->ready_queue, &block, 0);
+    }
+    ACQ_STAT_ADD(acq, blocks, 1);
+    return high_task_woken == pdTRUE;
+}
+
+IRAM_ATTR bool acq_push(acq_handle_t acq, const acq_conv_t *conv, size_t count, bool from_isr)
+{
+    const uint8_t channel_count = acq->config.channel_count;
+    bool need_yield = false;
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t pos = acq->frame_pos;
+        if (conv[i].channel != acq->channels[pos]) {
+            // 通道顺序错乱（丢了转换结果或刚启动）：丢弃半帧，等下一帧的第一个通道
+            if (pos != 0) {
+                ACQ_STAT_ADD(acq, resyncs, 1);
+                pos = 0;
+            }
+            if (conv[i].channel != acq->channels[0]) {
+                acq->frame_pos = 0;
+                continue;
+            }
+        }
+
+        if (pos == 0) {
+            // 新的一帧：直接写入当前块，没有空闲块时写入丢弃区
+            if (acq->filling == NULL && !acq_take_free_block(acq, from_isr)) {
+                acq->frame_ptr = acq->discard_frame;
+            } else {
+                acq->frame_ptr = acq_block_raw(acq, acq->filling) + acq->fill_frames * channel_count;
+            }
+        }
+        acq->frame_ptr[pos++] = conv[i].raw;
+
+        if (pos == channel_count) {
+            pos = 0;
+            if (acq->frame_ptr == acq->discard_frame) {
+                ACQ_STAT_ADD(acq, overrun_frames, 1);
+            } else {
+                ACQ_STAT_ADD(acq, frames, 1);
+                if (++acq->fill_frames == acq->config.block_frames) {
+                    need_yield |= acq_post_block(acq, from_isr);
+                }
+            }
+        }
+        acq->frame_pos = pos;
+    }
+    ACQ_STAT_ADD(acq, conversions, count);
+    return need_yield;
+}
+
+// ====================== 消费者侧 ======================
+acq_block_t *acq_receive(acq_handle_t acq, TickType_t timeout)
+{
+    acq_block_t *block = NULL;
+    if (xQueueReceive(acq->ready_queue, &block, timeout) != pdPASS) {
+        return NULL;
+    }
+    acq->config.decode(block->raw, block->frames, block->items, acq->config.decode_ctx);
+    return block;
+}
+
+void acq_release(acq_handle_t acq, acq_block_t *block)
+{
+    if (block != NULL) {
+        xQueueSend(acq->free_queue, &block, 0);
+    }
+}
+
+void acq_get_stats(acq_handle_t acq, acq_stats_t *stats)
+{
+    stats->conversions = __atomic_load_n(&acq->stats.conversions, __ATOMIC_RELAXED);
+    stats->frames = __atomic_load_n(&acq->stats.frames, __ATOMIC_RELAXED);
+    stats->blocks = __atomic_load_n(&acq->stats.blocks, __ATOMIC_RELAXED);
+    stats->overrun_frames = __atomic_load_n(&acq->stats.overrun_frames, __ATOMIC_RELAXED);
+    stats->resyncs = __atomic_load_n(&acq->stats.resyncs, __ATOMIC_RELAXED);
+}
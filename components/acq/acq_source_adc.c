@@ -0,0 +1,153 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "soc/soc_caps.h"
+#include "acq_source.h"
+
+/*
+ * 连续模式 ADC 数据源：ADC1 按扫描表依次转换各通道，结果由 DMA 写入驱动的帧缓冲区，
+ * 每完成一帧触发 on_conv_done 中断回调，在回调中把 DMA 结果解析为 acq_conv_t 并推给采集核心。
+ */
+
+static const char *TAG = "acq_adc";
+
+// 不同芯片的 DMA 结果格式不同（与 IDF 的 continuous_read 示例相同）
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define ACQ_ADC_OUTPUT_TYPE          ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define ACQ_ADC_GET_CHANNEL(p_data)  ((p_data)->type1.channel)
+#define ACQ_ADC_GET_DATA(p_data)     ((p_data)->type1.data)
+#else
+#define ACQ_ADC_OUTPUT_TYPE          ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define ACQ_ADC_GET_CHANNEL(p_data)  ((p_data)->type2.channel)
+#define ACQ_ADC_GET_DATA(p_data)     ((p_data)->type2.data)
+#endif
+
+#define ACQ_ADC_PARSE_BATCH  64   // 每次推给采集核心的转换结果数
+
+typedef struct {
+    acq_source_t base;
+    acq_adc_config_t config;
+    uint8_t channels[ACQ_MAX_CHANNELS];
+    adc_continuous_handle_t handle;
+    acq_handle_t acq;
+    uint32_t pool_overflows;
+    acq_conv_t parse_buf[ACQ_ADC_PARSE_BATCH];  // 只在 DMA 完成回调中使用，回调不会重入
+} adc_source_t;
+
+static bool IRAM_ATTR adc_on_conv_done(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata,
+                                       void *user_data)
+{
+    adc_source_t *adc = (adc_source_t *)user_data;
+    bool need_yield = false;
+    size_t n = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= edata->size; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *p = (const adc_digi_output_data_t *)&edata->conv_frame_buffer[i];
+        adc->parse_buf[n].channel = ACQ_ADC_GET_CHANNEL(p);
+        adc->parse_buf[n].raw = ACQ_ADC_GET_DATA(p);
+        if (++n == ACQ_ADC_PARSE_BATCH) {
+            need_yield |= acq_push(adc->acq, adc->parse_buf, n, true);
+            n = 0;
+        }
+    }
+    if (n > 0) {
+        need_yield |= acq_push(adc->acq, adc->parse_buf, n, true);
+    }
+    return need_yield;
+}
+
+static bool IRAM_ATTR adc_on_pool_ovf(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata,
+                                      void *user_data)
+{
+    // 数据已在 on_conv_done 中取走，驱动内部的缓冲池满只是计数
+    adc_source_t *adc = (adc_source_t *)user_data;
+    adc->pool_overflows++;
+    return false;
+}
+
+static esp_err_t adc_start(acq_source_t *source, acq_handle_t acq)
+{
+    adc_source_t *adc = (adc_source_t *)source;  // base 是第一个成员
+    adc->acq = acq;
+    return adc_continuous_start(adc->handle);
+}
+
+static esp_err_t adc_stop(acq_source_t *source)
+{
+    adc_source_t *adc = (adc_source_t *)source;
+    esp_err_t ret = adc_continuous_stop(adc->handle);
+    ESP_LOGD(TAG, "驱动缓冲池溢出 %" PRIu32 " 次", adc->pool_overflows);
+    return ret;
+}
+
+static void adc_del(acq_source_t *source)
+{
+    adc_source_t *adc = (adc_source_t *)source;
+    if (adc->handle != NULL) {
+        adc_continuous_deinit(adc->handle);
+    }
+    free(adc);
+}
+
+esp_err_t acq_source_new_adc(const acq_adc_config_t *config, acq_source_t **ret_source)
+{
+    ESP_RETURN_ON_FALSE(config && ret_source && config->channels && config->channel_count > 0 &&
+                        config->channel_count <= ACQ_MAX_CHANNELS && config->channel_count <= SOC_ADC_PATT_LEN_MAX,
+                        ESP_ERR_INVALID_ARG, TAG, "参数错误");
+    ESP_RETURN_ON_FALSE(config->frame_bytes % SOC_ADC_DIGI_DATA_BYTES_PER_CONV == 0, ESP_ERR_INVALID_ARG, TAG,
+                        "frame_bytes 必须是 %d 的整数倍", SOC_ADC_DIGI_DATA_BYTES_PER_CONV);
+
+    adc_source_t *adc = calloc(1, sizeof(*adc));
+    ESP_RETURN_ON_FALSE(adc, ESP_ERR_NO_MEM, TAG, "内存不足");
+    adc->config = *config;
+    memcpy(adc->channels, config->channels, config->channel_count);
+    adc->config.channels = adc->channels;
+    adc->base.start = adc_start;
+    adc->base.stop = adc_stop;
+    adc->base.del = adc_del;
+
+    esp_err_t ret = ESP_OK;
+    // 数据在完成回调中取走，驱动内部的缓冲池只需最小尺寸，满了直接清空
+    adc_continuous_handle_cfg_t handle_config = {
+        .max_store_buf_size = config->frame_bytes,
+        .conv_frame_size = config->frame_bytes,
+        .flags.flush_pool = true,
+    };
+    ESP_GOTO_ON_ERROR(adc_continuous_new_handle(&handle_config, &adc->handle), err, TAG, "创建连续模式 ADC 失败");
+
+    adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX] = { 0 };
+    for (int i = 0; i < config->channel_count; i++) {
+        pattern[i].atten = config->atten;
+        pattern[i].channel = config->channels[i];
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    adc_continuous_config_t dig_config = {
+        .pattern_num = config->channel_count,
+        .adc_pattern = pattern,
+        .sample_freq_hz = config->sample_freq_hz,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ACQ_ADC_OUTPUT_TYPE,
+    };
+    ESP_GOTO_ON_ERROR(adc_continuous_config(adc->handle, &dig_config), err, TAG, "配置连续模式 ADC 失败");
+
+    adc_continuous_evt_cbs_t callbacks = {
+        .on_conv_done = adc_on_conv_done,
+        .on_pool_ovf = adc_on_pool_ovf,
+    };
+    ESP_GOTO_ON_ERROR(adc_continuous_register_event_callbacks(adc->handle, &callbacks, adc), err, TAG,
+                      "注册 ADC 回调失败");
+
+    ESP_LOGI(TAG, "ADC1 %u 个通道，总速率 %" PRIu32 " Hz，每帧 %" PRIu32 " 字节", config->channel_count,
+             config->sample_freq_hz, config->frame_bytes);
+    *ret_source = &adc->base;
+    return ESP_OK;
+
+err:
+    adc_del(&adc->base);
+    return ret;
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "acq_source.h"
+
+/*
+ * 回放数据源：用一个任务按固定速率把录好的（或合成的）转换结果推给采集核心，
+ * 代替硬件 ADC，在 linux 目标上测试持续采集速率和 CPU 占用。
+ */
+
+static const char *TAG = "acq_replay";
+
+#define REPLAY_TASK_STACK    4096
+#define REPLAY_CHUNK_UNLIMITED  256   // 不限速时每次推送的转换结果数
+
+typedef struct {
+    acq_source_t base;
+    acq_replay_config_t config;
+    acq_conv_t *owned;       // 从文件读入的数据（内存数据源时为 NULL）
+    const acq_conv_t *data;
+    size_t count;
+    size_t cursor;
+    acq_handle_t acq;
+    TaskHandle_t task;
+    TaskHandle_t stopper;    // 等待回放任务退出的任务（在清除 running 之前写入）
+    bool running;            // 用 __atomic 读写：release 清除、acquire 读取，保证回放任务看到 stopper
+} replay_source_t;
+
+// 推送最多 n 个结果，返回实际推送数（到结尾且不循环时会少于 n）
+static size_t replay_push(replay_source_t *replay, size_t n)
+{
+    size_t pushed = 0;
+    while (pushed < n) {
+        if (replay->cursor == replay->count) {
+            if (!replay->config.loop) {
+                break;
+            }
+            replay->cursor = 0;
+        }
+        size_t chunk = replay->count - replay->cursor;
+        if (chunk > n - pushed) {
+            chunk = n - pushed;
+        }
+        acq_push(replay->acq, &replay->data[replay->cursor], chunk, false);
+        replay->cursor += chunk;
+        pushed += chunk;
+    }
+    return pushed;
+}
+
+static void replay_task(void *arg)
+{
+    replay_source_t *replay = (replay_source_t *)arg;
+    const uint32_t rate = replay->config.conv_rate_hz;
+    uint32_t remainder = 0;  // 不足一个节拍的速率余数
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (__atomic_load_n(&replay->running, __ATOMIC_ACQUIRE)) {
+        size_t due;
+        if (rate == 0) {
+            due = REPLAY_CHUNK_UNLIMITED;
+        } else {
+            vTaskDelayUntil(&last_wake, 1);
+            remainder += rate % configTICK_RATE_HZ;
+            due = rate / configTICK_RATE_HZ + remainder / configTICK_RATE_HZ;
+            remainder %= configTICK_RATE_HZ;
+        }
+        if (replay_push(replay, due) < due) {
+            // 不循环时回放结束，等待 stop
+            while (__atomic_load_n(&replay->running, __ATOMIC_ACQUIRE)) {
+                vTaskDelay(pdMS_TO_TICKS(10));
+            }
+            break;
+        }
+        if (rate == 0) {
+            taskYIELD();
+        }
+    }
+
+    xTaskNotifyGive(replay->stopper);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t replay_start(acq_source_t *source, acq_handle_t acq)
+{
+    replay_source_t *replay = (replay_source_t *)source;  // base 是第一个成员
+    replay->acq = acq;
+    __atomic_store_n(&replay->running, true, __ATOMIC_RELAXED);
+    if (xTaskCreate(replay_task, "AcqReplay", REPLAY_TASK_STACK, replay,
+                    replay->config.task_priority, &replay->task) != pdPASS) {
+        __atomic_store_n(&replay->running, false, __ATOMIC_RELAXED);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t replay_stop(acq_source_t *source)
+{
+    replay_source_t *replay = (replay_source_t *)source;  // base 是第一个成员
+    replay->stopper = xTaskGetCurrentTaskHandle();
+    // release：回放任务用 acquire 读到 running == false 时，一定能看到上面写入的 stopper（另一个核上也一样）
+    __atomic_store_n(&replay->running, false, __ATOMIC_RELEASE);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    replay->task = NULL;
+    return ESP_OK;
+}
+
+static void replay_del(acq_source_t *source)
+{
+    replay_source_t *replay = (replay_source_t *)source;  // base 是第一个成员
+    free(replay->owned);
+    free(replay);
+}
+
+static esp_err_t replay_load_file(replay_source_t *replay, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "无法打开回放文件 %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    size_t count = size > 0 ? (size_t)size / sizeof(acq_conv_t) : 0;
+    if (count == 0) {
+        fclose(f);
+        ESP_LOGE(TAG, "回放文件 %s 为空", path);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    replay->owned = malloc(count * sizeof(acq_conv_t));
+    if (replay->owned == NULL) {
+        fclose(f);
+        return ESP_ERR_NO_MEM;
+    }
+    size_t read = fread(replay->owned, sizeof(acq_conv_t), count, f);
+    fclose(f);
+    if (read != count) {
+        return ESP_FAIL;
+    }
+    replay->data = replay->owned;
+    replay->count = count;
+    ESP_LOGI(TAG, "已载入 %s：%u 个转换结果", path, (unsigned)count);
+    return ESP_OK;
+}
+
+esp_err_t acq_source_new_replay(const acq_replay_config_t *config, acq_source_t **ret_source)
+{
+    if (config == NULL || ret_source == NULL || (config->path == NULL && (config->data == NULL || config->count == 0))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    replay_source_t *replay = calloc(1, sizeof(*replay));
+    if (replay == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    replay->config = *config;
+    replay->base.start = replay_start;
+    replay->base.stop = replay_stop;
+    replay->base.del = replay_del;
+
+    if (config->path != NULL) {
+        esp_err_t ret = replay_load_file(replay, config->path);
+        if (ret != ESP_OK) {
+            replay_del(&replay->base);
+            return ret;
+        }
+    } else {
+        replay->data = config->data;
+        replay->count = config->count;
+    }
+    *ret_source = &replay->base;
+    return ESP_OK;
+}
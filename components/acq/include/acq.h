@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 高速采集：数据源（连续模式 ADC、文件回放……）把转换结果推给采集核心，
+ * 核心按扫描通道把结果拼成“帧”（每个通道一个原始值），装满一个数据块后整块交给消费者。
+ *
+ *   数据源 ──acq_push()──▶ [空闲块] ──装满──▶ [就绪块] ──acq_receive()──▶ 消费者 ──acq_release()──┐
+ *                              ▲────────────────────────────────────────────────────────────────┘
+ *
+ * - acq_push 可以在中断中调用，只做整数运算（按通道拼帧、写入块内的原始数据区）
+ * - 浮点换算（decode）在 acq_receive 中、任务上下文执行，直接写入块内的数据区，
+ *   消费者拿到的是块指针，不再逐个样本复制
+ * - 没有空闲块时丢弃整帧并计入 overrun_frames，数据源不会被阻塞
+ */
+
+#define ACQ_MAX_CHANNELS  8
+
+typedef struct acq *acq_handle_t;
+typedef struct acq_source acq_source_t;
+
+/**
+ * @brief  块解码函数（任务上下文）
+ * @param  raw     frames 帧原始数据，每帧 channel_count 个值，顺序与 channels 相同
+ * @param  frames  帧数
+ * @param  items   输出数组（frames 个元素，每个 item_size 字节）
+ * @param  ctx     acq_config_t::decode_ctx
+ */
+typedef void (*acq_decode_fn_t)(const uint16_t *raw, uint32_t frames, void *items, void *ctx);
+
+/**
+ * @brief  采集配置
+ */
+typedef struct {
+    const uint8_t *channels;  // 扫描的通道编号（帧内顺序）
+    uint8_t channel_count;    // 通道数（1~ACQ_MAX_CHANNELS）
+    size_t item_size;         // 解码后每帧的元素大小（如 sizeof(sensor_data_t)）
+    uint32_t block_frames;    // 每块的帧数
+    uint32_t block_count;     // 块数（至少 2：一块在填充，一块在处理）
+    acq_decode_fn_t decode;   // 解码函数
+    void *decode_ctx;         // 解码函数参数
+} acq_config_t;
+
+/**
+ * @brief  数据块
+ */
+typedef struct {
+    void *items;              // 解码后的数据（frames 个元素）
+    const uint16_t *raw;      // 原始数据（frames * channel_count 个值）
+    uint32_t frames;          // 帧数
+    uint32_t seq;             // 块序号（连续递增，可用于发现丢块）
+    int64_t timestamp_us;     // 最后一帧写入的时刻
+} acq_block_t;
+
+/**
+ * @brief  采集统计
+ */
+typedef struct {
+    uint32_t conversions;     // 收到的转换结果数
+    uint32_t frames;          // 拼好的帧数
+    uint32_t blocks;          // 交给消费者的块数
+    uint32_t overrun_frames;  // 没有空闲块而丢弃的帧数
+    uint32_t resyncs;         // 通道顺序错乱、重新对齐的次数
+} acq_stats_t;
+
+/**
+ * @brief  创建采集核心
+ * @param  source  数据源（acq_delete 时一并删除）
+ */
+esp_err_t acq_create(const acq_config_t *config, acq_source_t *source, acq_handle_t *ret_handle);
+
+/**
+ * @brief  启动数据源
+ */
+esp_err_t acq_start(acq_handle_t acq);
+
+/**
+ * @brief  停止数据源（未处理完的块仍可取出）
+ */
+esp_err_t acq_stop(acq_handle_t acq);
+
+/**
+ * @brief  停止并释放采集核心和数据源（调用前消费者必须归还所有块）
+ */
+void acq_delete(acq_handle_t acq);
+
+/**
+ * @brief  取出一个装满的块并解码
+ * @return 超时返回 NULL；处理完后必须调用 acq_release 归还
+ */
+acq_block_t *acq_receive(acq_handle_t acq, TickType_t timeout);
+
+/**
+ * @brief  归还数据块
+ */
+void acq_release(acq_handle_t acq, acq_block_t *block);
+
+/**
+ * @brief  读取统计
+ */
+void acq_get_stats(acq_handle_t acq, acq_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_err.h"
+#include "acq.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "hal/adc_types.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  一个转换结果
+ * @note   同时也是回放文件的记录格式（小端，每条 4 字节）
+ */
+typedef struct {
+    uint16_t channel;
+    uint16_t raw;
+} acq_conv_t;
+
+/**
+ * @brief  数据源接口：新的数据源实现这三个函数，并在产生数据时调用 acq_push
+ */
+struct acq_source {
+    esp_err_t (*start)(acq_source_t *source, acq_handle_t acq);
+    esp_err_t (*stop)(acq_source_t *source);
+    void (*del)(acq_source_t *source);
+};
+
+/**
+ * @brief  数据源推送转换结果（同一时刻只能有一个调用者）
+ * @param  from_isr  在中断中调用时为 true
+ * @return 唤醒了更高优先级的任务（中断返回前需要切换）时返回 true
+ */
+bool acq_push(acq_handle_t acq, const acq_conv_t *conv, size_t count, bool from_isr);
+
+/**
+ * @brief  回放数据源配置：按固定速率重放一段转换结果（文件或内存），用于 linux 目标和基准测试
+ */
+typedef struct {
+    const char *path;          // 回放文件（acq_conv_t 记录），为 NULL 时使用 data
+    const acq_conv_t *data;    // 内存中的转换结果（调用者保证在数据源删除前有效）
+    size_t count;              // data 的记录数
+    uint32_t conv_rate_hz;     // 每秒推送的转换结果数，0 表示不限速
+    bool loop;                 // 到结尾后从头重放
+    UBaseType_t task_priority; // 回放任务优先级
+} acq_replay_config_t;
+
+/**
+ * @brief  创建回放数据源（文件在创建时整体读入内存，回放过程不做文件 I/O）
+ */
+esp_err_t acq_source_new_replay(const acq_replay_config_t *config, acq_source_t **ret_source);
+
+#if !CONFIG_IDF_TARGET_LINUX
+/**
+ * @brief  连续模式 ADC 数据源配置（ADC1，DMA 传输）
+ */
+typedef struct {
+    const uint8_t *channels;    // ADC1 通道（与 acq_config_t::channels 相同）
+    uint8_t channel_count;
+    adc_atten_t atten;          // 衰减
+    uint32_t sample_freq_hz;    // 总转换速率（所有通道合计）
+    uint32_t frame_bytes;       // 每次 DMA 完成中断处理的字节数，必须是 SOC_ADC_DIGI_DATA_BYTES_PER_CONV 的整数倍
+} acq_adc_config_t;
+
+/**
+ * @brief  创建连续模式 ADC 数据源
+ * @note   DMA 在驱动内部的多个 frame_bytes 缓冲区之间轮换，一个缓冲区在完成回调中解析时其余的继续采集；
+ *         转换结果在回调中直接推给采集核心，不经过驱动内部的环形缓冲区（满时由驱动直接清空）
+ */
+esp_err_t acq_source_new_adc(const acq_adc_config_t *config, acq_source_t **ret_source);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
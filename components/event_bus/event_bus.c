@@ -0,0 +1,345 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "event_bus.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_attr.h"
+#include "esp_timer.h"
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+static const char *TAG = "event_bus";
+
+/*
+ * 环形缓冲区采用 Vyukov 的有界 MPMC 队列：每个槽带一个序号，生产者/消费者各用一个位置计数器，
+ * 通过 CAS 抢占位置，抢到后写入数据再发布槽序号。不用锁也不关中断，任务和中断都能直接调用。
+ */
+typedef struct {
+    uint32_t seq;
+    event_bus_event_t event;
+} event_bus_cell_t;
+
+typedef struct {
+    event_bus_handler_t handler;
+    void *ctx;
+    uint32_t topics;
+} event_bus_subscriber_t;
+
+typedef struct {
+    struct event_bus *bus;
+    uint32_t index;
+    TaskHandle_t task;
+} event_bus_dispatcher_t;
+
+struct event_bus {
+    event_bus_config_t config;
+    event_bus_cell_t *cells;
+    uint32_t mask;
+    uint32_t enqueue_pos;
+    uint32_t dequeue_pos;
+
+    event_bus_subscriber_t *subscribers;
+    uint32_t subscriber_count;
+    uint32_t subscribed_topics;   // 所有订阅者主题的并集，用于发布时过滤
+
+    event_bus_dispatcher_t dispatchers[EVENT_BUS_MAX_DISPATCHERS];
+    uint32_t idle_dispatchers;    // 正在等待唤醒的分发任务（位图）
+    volatile bool running;
+    TaskHandle_t deleter;         // 等待分发任务退出的任务
+
+    event_bus_stats_t stats;
+};
+
+#define EVENT_BUS_STAT_ADD(bus, field, n)  __atomic_fetch_add(&(bus)->stats.field, (n), __ATOMIC_RELAXED)
+
+#if CONFIG_IDF_TARGET_LINUX
+static uint32_t event_bus_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+#else
+#define event_bus_now_us()  ((uint32_t)esp_timer_get_time())
+#endif
+
+// ====================== 无锁环形缓冲区 ======================
+static IRAM_ATTR bool event_bus_enqueue(struct event_bus *bus, const event_bus_event_t *event)
+{
+    uint32_t pos = __atomic_load_n(&bus->enqueue_pos, __ATOMIC_RELAXED);
+    event_bus_cell_t *cell;
+    while (true) {
+        cell = &bus->cells[pos & bus->mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&bus->enqueue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // 槽还没被消费者释放：缓冲区满
+        } else {
+            pos = __atomic_load_n(&bus->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+    cell->event = *event;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool event_bus_dequeue(struct event_bus *bus, event_bus_event_t *event)
+{
+    uint32_t pos = __atomic_load_n(&bus->dequeue_pos, __ATOMIC_RELAXED);
+    event_bus_cell_t *cell;
+    while (true) {
+        cell = &bus->cells[pos & bus->mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&bus->dequeue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // 槽还没写入：缓冲区空（或生产者正在写）
+        } else {
+            pos = __atomic_load_n(&bus->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+    *event = cell->event;
+    __atomic_store_n(&cell->seq, pos + bus->mask + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool event_bus_has_data(struct event_bus *bus)
+{
+    uint32_t pos = __atomic_load_n(&bus->dequeue_pos, __ATOMIC_RELAXED);
+    const event_bus_cell_t *cell = &bus->cells[pos & bus->mask];
+    return __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) == pos + 1;
+}
+
+// ====================== 发布 ======================
+static IRAM_ATTR esp_err_t event_bus_publish_common(struct event_bus *bus, uint32_t topic, uint32_t id,
+                                                    uint32_t value, bool from_isr, BaseType_t *higher_prio_task_woken)
+{
+    if ((__atomic_load_n(&bus->subscribed_topics, __ATOMIC_RELAXED) & topic) == 0) {
+        EVENT_BUS_STAT_ADD(bus, filtered, 1);
+        return ESP_OK;
+    }
+    event_bus_event_t event = {
+        .topic = topic,
+        .id = id,
+        .value = value,
+        .timestamp_us = event_bus_now_us(),
+    };
+    if (!event_bus_enqueue(bus, &event)) {
+        EVENT_BUS_STAT_ADD(bus, dropped, 1);
+        return ESP_ERR_NO_MEM;
+    }
+    EVENT_BUS_STAT_ADD(bus, published, 1);
+
+    // 与分发任务“先标记空闲、再检查缓冲区”配对：两边都用顺序一致的内存序，保证不会丢失唤醒
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint32_t idle = __atomic_load_n(&bus->idle_dispatchers, __ATOMIC_SEQ_CST);
+    while (idle != 0) {
+        uint32_t bit = idle & -idle;  // 唤醒编号最小的空闲分发任务
+        idle = __atomic_fetch_and(&bus->idle_dispatchers, ~bit, __ATOMIC_SEQ_CST);
+        if (idle & bit) {
+            TaskHandle_t task = bus->dispatchers[__builtin_ctz(bit)].task;
+            if (from_isr) {
+                vTaskNotifyGiveFromISR(task, higher_prio_task_woken);
+            } else {
+                xTaskNotifyGive(task);
+            }
+            break;
+        }
+        idle &= ~bit;  // 被其它生产者抢先唤醒了，看下一个
+    }
+    return ESP_OK;
+}
+
+esp_err_t event_bus_publish(event_bus_handle_t bus, uint32_t topic, uint32_t id, uint32_t value)
+{
+    return event_bus_publish_common(bus, topic, id, value, false, NULL);
+}
+
+IRAM_ATTR esp_err_t event_bus_publish_from_isr(event_bus_handle_t bus, uint32_t topic, uint32_t id, uint32_t value,
+                                               BaseType_t *higher_prio_task_woken)
+{
+    return event_bus_publish_common(bus, topic, id, value, true, higher_prio_task_woken);
+}
+
+// ====================== 分发 ======================
+static void event_bus_deliver(struct event_bus *bus, const event_bus_event_t *batch, size_t count)
+{
+    event_bus_event_t filtered[EVENT_BUS_MAX_BATCH];
+    uint32_t subscriber_count = __atomic_load_n(&bus->subscriber_count, __ATOMIC_ACQUIRE);
+    for (uint32_t s = 0; s < subscriber_count; s++) {
+        const event_bus_subscriber_t *sub = &bus->subscribers[s];
+        size_t matched = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (batch[i].topic & sub->topics) {
+                filtered[matched++] = batch[i];
+            }
+        }
+        if (matched == 0) {
+            continue;
+        }
+        // 整批都匹配时直接交付原数组，省掉拷贝
+        sub->handler(matched == count ? batch : filtered, matched, sub->ctx);
+        EVENT_BUS_STAT_ADD(bus, delivered, matched);
+    }
+}
+
+static void event_bus_dispatch_task(void *arg)
+{
+    event_bus_dispatcher_t *dispatcher = (event_bus_dispatcher_t *)arg;
+    struct event_bus *bus = dispatcher->bus;
+    const uint32_t bit = 1u << dispatcher->index;
+    event_bus_event_t batch[EVENT_BUS_MAX_BATCH];
+
+    while (bus->running) {
+        size_t count = 0;
+        while (count < bus->config.batch_size && event_bus_dequeue(bus, &batch[count])) {
+            count++;
+        }
+        if (count > 0) {
+            EVENT_BUS_STAT_ADD(bus, batches, 1);
+            event_bus_deliver(bus, batch, count);
+            continue;
+        }
+
+        // 缓冲区空：先标记空闲再检查一次，避免生产者在两步之间发布的事件没人处理
+        __atomic_fetch_or(&bus->idle_dispatchers, bit, __ATOMIC_SEQ_CST);
+        if (event_bus_has_data(bus)) {
+            __atomic_fetch_and(&bus->idle_dispatchers, ~bit, __ATOMIC_SEQ_CST);
+            continue;
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        EVENT_BUS_STAT_ADD(bus, wakeups, 1);
+    }
+
+    // 通知删除方后不再访问 bus：由删除方在所有分发任务都确认后删除本任务、释放 bus
+    xTaskNotifyGive(bus->deleter);
+    vTaskSuspend(NULL);
+}
+
+// ====================== 创建与删除 ======================
+esp_err_t event_bus_create(const event_bus_config_t *config, event_bus_handle_t *ret_bus)
+{
+    if (config == NULL || ret_bus == NULL || config->capacity < 2 || (config->capacity & (config->capacity - 1)) ||
+        config->max_subscribers == 0 || config->batch_size == 0 || config->batch_size > EVENT_BUS_MAX_BATCH ||
+        config->dispatcher_count == 0 || config->dispatcher_count > EVENT_BUS_MAX_DISPATCHERS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct event_bus *bus = calloc(1, sizeof(*bus));
+    if (bus == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    bus->config = *config;
+    bus->mask = config->capacity - 1;
+    bus->cells = calloc(config->capacity, sizeof(event_bus_cell_t));
+    bus->subscribers = calloc(config->max_subscribers, sizeof(event_bus_subscriber_t));
+    if (bus->cells == NULL || bus->subscribers == NULL) {
+        event_bus_delete(bus);
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < config->capacity; i++) {
+        bus->cells[i].seq = i;
+    }
+
+    bus->running = true;
+    for (uint32_t i = 0; i < config->dispatcher_count; i++) {
+        event_bus_dispatcher_t *dispatcher = &bus->dispatchers[i];
+        dispatcher->bus = bus;
+        dispatcher->index = i;
+        if (xTaskCreate(event_bus_dispatch_task, "EventBus", config->dispatcher_stack, dispatcher,
+                        config->dispatcher_priority, &dispatcher->task) != pdPASS) {
+            event_bus_delete(bus);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    ESP_LOGD(TAG, "容量 %" PRIu32 "，%" PRIu32 " 个分发任务，每批最多 %" PRIu32 " 个事件",
+             config->capacity, config->dispatcher_count, config->batch_size);
+    *ret_bus = bus;
+    return ESP_OK;
+}
+
+void event_bus_delete(event_bus_handle_t bus)
+{
+    if (bus == NULL) {
+        return;
+    }
+    bus->deleter = xTaskGetCurrentTaskHandle();
+    bus->running = false;
+    uint32_t pending = 0;
+    for (uint32_t i = 0; i < EVENT_BUS_MAX_DISPATCHERS; i++) {
+        if (bus->dispatchers[i].task != NULL) {
+            xTaskNotifyGive(bus->dispatchers[i].task);
+            pending++;
+        }
+    }
+    // 分发任务退出循环后先通知再挂起自己，确认之后不再访问 bus；全部确认后再删除它们、释放 bus
+    for (uint32_t i = 0; i < pending; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+    for (uint32_t i = 0; i < EVENT_BUS_MAX_DISPATCHERS; i++) {
+        if (bus->dispatchers[i].task != NULL) {
+            vTaskDelete(bus->dispatchers[i].task);
+        }
+    }
+    free(bus->subscribers);
+    free(bus->cells);
+    free(bus);
+}
+
+esp_err_t event_bus_subscribe(event_bus_handle_t bus, uint32_t topics, event_bus_handler_t handler, void *ctx)
+{
+    if (handler == NULL || topics == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t index = __atomic_load_n(&bus->subscriber_count, __ATOMIC_RELAXED);
+    if (index >= bus->config.max_subscribers) {
+        return ESP_ERR_NO_MEM;
+    }
+    // 先写好订阅者再发布计数，分发任务读到的条目总是完整的
+    bus->subscribers[index] = (event_bus_subscriber_t) {
+        .handler = handler,
+        .ctx = ctx,
+        .topics = topics,
+    };
+    __atomic_store_n(&bus->subscriber_count, index + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_or(&bus->subscribed_topics, topics, __ATOMIC_RELAXED);
+    return ESP_OK;
+}
+
+void event_bus_get_stats(event_bus_handle_t bus, event_bus_stats_t *stats)
+{
+    stats->published = __atomic_load_n(&bus->stats.published, __ATOMIC_RELAXED);
+    stats->filtered = __atomic_load_n(&bus->stats.filtered, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&bus->stats.dropped, __ATOMIC_RELAXED);
+    stats->delivered = __atomic_load_n(&bus->stats.delivered, __ATOMIC_RELAXED);
+    stats->batches = __atomic_load_n(&bus->stats.batches, __ATOMIC_RELAXED);
+    stats->wakeups = __atomic_load_n(&bus->stats.wakeups, __ATOMIC_RELAXED);
+}
+
+void event_bus_log_stats(event_bus_handle_t bus, const char *name)
+{
+    event_bus_stats_t stats;
+    event_bus_get_stats(bus, &stats);
+    uint32_t dequeued = __atomic_load_n(&bus->dequeue_pos, __ATOMIC_RELAXED);
+    ESP_LOGI(TAG, "%s：发布 %" PRIu32 "，过滤 %" PRIu32 "，丢弃 %" PRIu32 "，交付 %" PRIu32 "，%" PRIu32
+             " 批（平均每批 %.1f 个事件），分发任务唤醒 %" PRIu32 " 次", name, stats.published, stats.filtered,
+             stats.dropped, stats.delivered, stats.batches,
+             stats.batches > 0 ? (float)dequeued / stats.batches : 0.0f, stats.wakeups);
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 事件总线：触摸、GPIO、定时器等事件统一发布到一个无锁多生产者多消费者环形缓冲区，
+ * 由少量分发任务批量取出，按主题位掩码交给订阅者的回调。
+ *   - 发布不加锁、不阻塞，任务和中断中都可以调用（缓冲区满时丢弃并计数）
+ *   - 没有订阅者关心的主题在发布时直接过滤，不占缓冲区、不唤醒分发任务
+ *   - 分发任务空闲时才需要唤醒：连续到达的事件在一次唤醒中成批处理
+ * 订阅者回调在分发任务中执行，不能长时间阻塞（需要延时的处理用定时器事件代替 vTaskDelay）。
+ * 有多个分发任务时，同一订阅者的回调可能被并发调用，需要按顺序处理事件的场景请只用一个分发任务。
+ */
+
+typedef struct event_bus *event_bus_handle_t;
+
+/**
+ * @brief  预定义主题（每个主题占一位，订阅时可以按位或组合）
+ */
+#define EVENT_TOPIC_GPIO   (1u << 0)   // id：GPIO 编号，value：电平
+#define EVENT_TOPIC_TOUCH  (1u << 1)   // id：触摸通道，value：触摸事件（touch_button_event_t 等）
+#define EVENT_TOPIC_TIMER  (1u << 2)   // id：定时器编号（由应用定义），value：应用定义
+#define EVENT_TOPIC_USER   (1u << 8)   // 应用自定义主题从这一位开始
+#define EVENT_TOPIC_ALL    UINT32_MAX
+
+#define EVENT_BUS_MAX_DISPATCHERS  4
+#define EVENT_BUS_MAX_BATCH        32
+
+/**
+ * @brief  事件
+ */
+typedef struct {
+    uint32_t topic;         // 主题（只能有一位）
+    uint32_t id;            // 事件来源
+    uint32_t value;         // 事件数据
+    uint32_t timestamp_us;  // 发布时间（微秒时间戳的低 32 位）
+} event_bus_event_t;
+
+/**
+ * @brief  订阅者回调：一次交付一批匹配主题的事件（按发布顺序）
+ */
+typedef void (*event_bus_handler_t)(const event_bus_event_t *events, size_t count, void *ctx);
+
+/**
+ * @brief  事件总线配置
+ */
+typedef struct {
+    uint32_t capacity;          // 环形缓冲区容量（2 的幂）
+    uint32_t max_subscribers;   // 订阅者数量上限
+    uint32_t batch_size;        // 分发任务每批最多取出的事件数（不超过 EVENT_BUS_MAX_BATCH）
+    uint32_t dispatcher_count;  // 分发任务数（不超过 EVENT_BUS_MAX_DISPATCHERS）
+    UBaseType_t dispatcher_priority;
+    uint32_t dispatcher_stack;  // 分发任务栈大小（字节）
+} event_bus_config_t;
+
+#define EVENT_BUS_DEFAULT_CONFIG() {    \
+    .capacity = 64,                     \
+    .max_subscribers = 8,               \
+    .batch_size = 16,                   \
+    .dispatcher_count = 1,              \
+    .dispatcher_priority = 5,           \
+    .dispatcher_stack = 4096,           \
+}
+
+/**
+ * @brief  事件总线统计
+ */
+typedef struct {
+    uint32_t published;     // 进入缓冲区的事件数
+    uint32_t filtered;      // 没有订阅者关心、在发布时过滤掉的事件数
+    uint32_t dropped;       // 缓冲区满而丢弃的事件数
+    uint32_t delivered;     // 交付给订阅者的事件数（一个事件交给多个订阅者时计多次）
+    uint32_t batches;       // 分发任务取出的批次数
+    uint32_t wakeups;       // 分发任务被唤醒的次数
+} event_bus_stats_t;
+
+/**
+ * @brief  创建事件总线并启动分发任务
+ */
+esp_err_t event_bus_create(const event_bus_config_t *config, event_bus_handle_t *ret_bus);
+
+/**
+ * @brief  停止分发任务并释放事件总线（调用前停止所有发布者）
+ */
+void event_bus_delete(event_bus_handle_t bus);
+
+/**
+ * @brief  订阅主题（在初始化阶段调用，不能与其它 event_bus_subscribe 并发；订阅后不能取消）
+ * @param  topics   主题位掩码
+ * @param  handler  回调（在分发任务中执行）
+ * @param  ctx      回调参数
+ * @return
+ *     - ESP_OK             成功
+ *     - ESP_ERR_NO_MEM     订阅者数量已达上限
+ */
+esp_err_t event_bus_subscribe(event_bus_handle_t bus, uint32_t topics, event_bus_handler_t handler, void *ctx);
+
+/**
+ * @brief  发布事件（任务中调用）
+ * @return
+ *     - ESP_OK                 已进入缓冲区，或没有订阅者而被过滤
+ *     - ESP_ERR_NO_MEM         缓冲区满，事件被丢弃
+ */
+esp_err_t event_bus_publish(event_bus_handle_t bus, uint32_t topic, uint32_t id, uint32_t value);
+
+/**
+ * @brief  发布事件（中断中调用）
+ * @param  higher_prio_task_woken  唤醒了更高优先级的分发任务时置为 pdTRUE，中断退出前需要 portYIELD_FROM_ISR
+ */
+esp_err_t event_bus_publish_from_isr(event_bus_handle_t bus, uint32_t topic, uint32_t id, uint32_t value,
+                                     BaseType_t *higher_prio_task_woken);
+
+/**
+ * @brief  读取统计
+ */
+void event_bus_get_stats(event_bus_handle_t bus, event_bus_stats_t *stats);
+
+/**
+ * @brief  用 ESP_LOGI 打印统计
+ */
+void event_bus_log_stats(event_bus_handle_t bus, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,302 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "flow_ctrl.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#endif
+
+static const char *TAG = "flow_ctrl";
+
+#define FLOW_DEFAULT_MAX_DECIMATION  8
+
+// 队列元素 = 入队时间戳 + 用户数据
+typedef struct {
+    uint32_t enqueue_us;
+    uint8_t payload[];
+} flow_item_t;
+
+struct flow_ctrl {
+    QueueHandle_t queue;
+    flow_ctrl_config_t config;
+    size_t slot_size;            // sizeof(flow_item_t) + item_size
+    flow_item_t *tx_slot;        // 发送端暂存
+    flow_item_t *rx_slot;        // 接收端暂存
+    flow_item_t *drop_slot;      // DROP_OLDEST 时丢弃的旧元素
+
+    // 以下状态只由发送任务修改
+    bool under_pressure;
+    uint32_t decimation;
+    uint32_t decimation_phase;
+    uint32_t calm_sends;         // 解除背压后低水位下的发送次数（用于逐步减小抽取倍数）
+    uint32_t last_escalate;      // 上次加大抽取倍数时的 offered 计数
+
+    // 统计（原子读写，收发两端都会更新）
+    uint32_t offered;
+    uint32_t sent;
+    uint32_t received;
+    uint32_t dropped_newest;
+    uint32_t dropped_oldest;
+    uint32_t decimated;
+    uint32_t pressure_events;
+    uint32_t peak_depth;
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+};
+
+#if CONFIG_IDF_TARGET_LINUX
+static uint32_t flow_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+#else
+#define flow_now_us()  ((uint32_t)esp_timer_get_time())
+#endif
+
+#define FLOW_STAT_INC(fc, field)  __atomic_fetch_add(&(fc)->field, 1, __ATOMIC_RELAXED)
+#define FLOW_STAT_GET(fc, field)  __atomic_load_n(&(fc)->field, __ATOMIC_RELAXED)
+
+static void flow_stat_max(uint32_t *target, uint32_t value)
+{
+    uint32_t current = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (value > current && !__atomic_compare_exchange_n(target, &current, value, true,
+                                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+esp_err_t flow_ctrl_create(const flow_ctrl_config_t *config, flow_ctrl_handle_t *ret_handle)
+{
+    if (config == NULL || ret_handle == NULL || config->item_size == 0 || config->capacity < 2 ||
+        config->policy > FLOW_SHED_DOWNSAMPLE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct flow_ctrl *fc = calloc(1, sizeof(*fc));
+    if (fc == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    fc->config = *config;
+    if (fc->config.high_watermark == 0 || fc->config.high_watermark > config->capacity) {
+        fc->config.high_watermark = config->capacity * 3 / 4;
+    }
+    if (fc->config.low_watermark == 0 || fc->config.low_watermark >= fc->config.high_watermark) {
+        fc->config.low_watermark = fc->config.high_watermark / 3;
+    }
+    if (fc->config.max_decimation == 0) {
+        fc->config.max_decimation = FLOW_DEFAULT_MAX_DECIMATION;
+    }
+    fc->decimation = 1;
+
+    fc->slot_size = sizeof(flow_item_t) + config->item_size;
+    fc->queue = xQueueCreate(config->capacity, fc->slot_size);
+    fc->tx_slot = malloc(fc->slot_size);
+    fc->rx_slot = malloc(fc->slot_size);
+    fc->drop_slot = malloc(fc->slot_size);
+    if (fc->queue == NULL || fc->tx_slot == NULL || fc->rx_slot == NULL || fc->drop_slot == NULL) {
+        flow_ctrl_delete(fc);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGD(TAG, "容量 %" PRIu32 "，水位 %" PRIu32 "/%" PRIu32 "，策略 %s", config->capacity,
+             fc->config.high_watermark, fc->config.low_watermark, flow_ctrl_policy_name(config->policy));
+    *ret_handle = fc;
+    return ESP_OK;
+}
+
+void flow_ctrl_delete(flow_ctrl_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    if (handle->queue != NULL) {
+        vQueueDelete(handle->queue);
+    }
+    free(handle->tx_slot);
+    free(handle->rx_slot);
+    free(handle->drop_slot);
+    free(handle);
+}
+
+// ====================== 背压与抽取（发送任务中执行） ======================
+static void flow_escalate(struct flow_ctrl *fc)
+{
+    fc->last_escalate = fc->offered;
+    fc->calm_sends = 0;
+    if (fc->decimation < fc->config.max_decimation) {
+        fc->decimation *= 2;
+    }
+}
+
+static void flow_update_pressure(struct flow_ctrl *fc, uint32_t depth)
+{
+    if (!fc->under_pressure && depth >= fc->config.high_watermark) {
+        __atomic_store_n(&fc->under_pressure, true, __ATOMIC_RELAXED);
+        FLOW_STAT_INC(fc, pressure_events);
+        flow_escalate(fc);
+        if (fc->config.on_pressure != NULL) {
+            fc->config.on_pressure(true, fc->config.user_ctx);
+        }
+    } else if (fc->under_pressure && depth <= fc->config.low_watermark) {
+        __atomic_store_n(&fc->under_pressure, false, __ATOMIC_RELAXED);
+        fc->calm_sends = 0;
+        if (fc->config.on_pressure != NULL) {
+            fc->config.on_pressure(false, fc->config.user_ctx);
+        }
+    } else if (!fc->under_pressure && fc->decimation > 1 && depth <= fc->config.low_watermark) {
+        // 持续处于低水位：每发送一整个队列长度的数据，抽取倍数减半
+        if (++fc->calm_sends >= fc->config.capacity) {
+            fc->calm_sends = 0;
+            fc->decimation /= 2;
+        }
+    }
+}
+
+flow_send_result_t flow_ctrl_send(flow_ctrl_handle_t handle, const void *item)
+{
+    struct flow_ctrl *fc = handle;
+    FLOW_STAT_INC(fc, offered);
+
+    uint32_t depth = uxQueueMessagesWaiting(fc->queue);
+    flow_update_pressure(fc, depth);
+
+    if (fc->config.policy == FLOW_SHED_DOWNSAMPLE && fc->decimation > 1 &&
+        ++fc->decimation_phase % fc->decimation != 0) {
+        FLOW_STAT_INC(fc, decimated);
+        return FLOW_SEND_DECIMATED;
+    }
+
+    fc->tx_slot->enqueue_us = flow_now_us();
+    memcpy(fc->tx_slot->payload, item, fc->config.item_size);
+    if (xQueueSend(fc->queue, fc->tx_slot, 0) == pdPASS) {
+        FLOW_STAT_INC(fc, sent);
+        flow_stat_max(&fc->peak_depth, depth + 1);
+        return FLOW_SEND_OK;
+    }
+
+    // 队列满：消费者明显跟不上，每提交一整个队列长度最多加大一次抽取倍数
+    if (fc->offered - fc->last_escalate >= fc->config.capacity) {
+        flow_escalate(fc);
+    }
+    flow_stat_max(&fc->peak_depth, fc->config.capacity);
+
+    if (fc->config.policy == FLOW_SHED_DROP_OLDEST) {
+        if (xQueueReceive(fc->queue, fc->drop_slot, 0) == pdPASS) {
+            FLOW_STAT_INC(fc, dropped_oldest);
+        }
+        if (xQueueSend(fc->queue, fc->tx_slot, 0) == pdPASS) {
+            FLOW_STAT_INC(fc, sent);
+            return FLOW_SEND_REPLACED_OLDEST;
+        }
+    }
+    FLOW_STAT_INC(fc, dropped_newest);
+    return FLOW_SEND_DROPPED;
+}
+
+bool flow_ctrl_receive(flow_ctrl_handle_t handle, void *item, TickType_t timeout, uint32_t *latency_us)
+{
+    struct flow_ctrl *fc = handle;
+    if (xQueueReceive(fc->queue, fc->rx_slot, timeout) != pdPASS) {
+        return false;
+    }
+    uint32_t latency = flow_now_us() - fc->rx_slot->enqueue_us;
+    memcpy(item, fc->rx_slot->payload, fc->config.item_size);
+
+    FLOW_STAT_INC(fc, received);
+    __atomic_fetch_add(&fc->latency_sum_us, (uint64_t)latency, __ATOMIC_RELAXED);
+    flow_stat_max(&fc->latency_max_us, latency);
+    if (latency_us != NULL) {
+        *latency_us = latency;
+    }
+    return true;
+}
+
+uint32_t flow_ctrl_get_decimation(flow_ctrl_handle_t handle)
+{
+    return __atomic_load_n(&handle->decimation, __ATOMIC_RELAXED);
+}
+
+bool flow_ctrl_under_pressure(flow_ctrl_handle_t handle)
+{
+    return __atomic_load_n(&handle->under_pressure, __ATOMIC_RELAXED);
+}
+
+QueueHandle_t flow_ctrl_get_queue(flow_ctrl_handle_t handle)
+{
+    return handle->queue;
+}
+
+// ====================== 统计 ======================
+void flow_ctrl_get_stats(flow_ctrl_handle_t handle, flow_ctrl_stats_t *stats)
+{
+    struct flow_ctrl *fc = handle;
+    memset(stats, 0, sizeof(*stats));
+    stats->offered = FLOW_STAT_GET(fc, offered);
+    stats->sent = FLOW_STAT_GET(fc, sent);
+    stats->received = FLOW_STAT_GET(fc, received);
+    stats->dropped_newest = FLOW_STAT_GET(fc, dropped_newest);
+    stats->dropped_oldest = FLOW_STAT_GET(fc, dropped_oldest);
+    stats->decimated = FLOW_STAT_GET(fc, decimated);
+    stats->pressure_events = FLOW_STAT_GET(fc, pressure_events);
+    stats->peak_depth = FLOW_STAT_GET(fc, peak_depth);
+    stats->latency_max_us = FLOW_STAT_GET(fc, latency_max_us);
+    stats->under_pressure = flow_ctrl_under_pressure(fc);
+    stats->decimation = flow_ctrl_get_decimation(fc);
+    stats->depth = uxQueueMessagesWaiting(fc->queue);
+
+    uint32_t shed = stats->dropped_newest + stats->dropped_oldest + stats->decimated;
+    stats->drop_rate = stats->offered > 0 ? (float)shed / stats->offered : 0.0f;
+    uint64_t latency_sum = FLOW_STAT_GET(fc, latency_sum_us);
+    stats->latency_avg_us = stats->received > 0 ? (uint32_t)(latency_sum / stats->received) : 0;
+}
+
+void flow_ctrl_reset_stats(flow_ctrl_handle_t handle)
+{
+    struct flow_ctrl *fc = handle;
+    __atomic_store_n(&fc->offered, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->sent, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->received, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->dropped_newest, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->dropped_oldest, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->decimated, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->pressure_events, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->peak_depth, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->latency_sum_us, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fc->latency_max_us, 0, __ATOMIC_RELAXED);
+    fc->last_escalate = 0;
+}
+
+void flow_ctrl_log_stats(flow_ctrl_handle_t handle, const char *name)
+{
+    flow_ctrl_stats_t stats;
+    flow_ctrl_get_stats(handle, &stats);
+    ESP_LOGI(TAG, "%s：提交 %" PRIu32 "，入队 %" PRIu32 "，取出 %" PRIu32 "，丢新 %" PRIu32 "，丢旧 %" PRIu32
+             "，抽取 %" PRIu32 "（丢弃率 %.1f%%）", name, stats.offered, stats.sent, stats.received,
+             stats.dropped_newest, stats.dropped_oldest, stats.decimated, stats.drop_rate * 100.0f);
+    ESP_LOGI(TAG, "%s：深度 %" PRIu32 "/峰值 %" PRIu32 "，背压 %" PRIu32 " 次%s，抽取倍数 %" PRIu32
+             "，排队延迟 平均 %" PRIu32 " us / 最大 %" PRIu32 " us", name, stats.depth, stats.peak_depth,
+             stats.pressure_events, stats.under_pressure ? "（当前背压中）" : "", stats.decimation,
+             stats.latency_avg_us, stats.latency_max_us);
+}
+
+const char *flow_ctrl_policy_name(flow_shed_policy_t policy)
+{
+    switch (policy) {
+    case FLOW_SHED_DROP_NEWEST:
+        return "drop_newest";
+    case FLOW_SHED_DROP_OLDEST:
+        return "drop_oldest";
+    case FLOW_SHED_DOWNSAMPLE:
+        return "downsample";
+    default:
+        return "unknown";
+    }
+}
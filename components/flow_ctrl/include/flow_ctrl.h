@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 流控通道：在 FreeRTOS 队列外加一层背压与降载。
+ *   - 发送永不阻塞：队列满时按丢弃策略处理，生产者不会因为消费者变慢而卡住
+ *   - 水位线：深度达到高水位时进入“背压”状态（回调通知），降到低水位时解除
+ *   - 自适应抽取：背压期间抽取倍数加倍，恢复后逐步减半；生产者可据此降低采样率，
+ *     DOWNSAMPLE 策略下由通道直接按倍数丢弃样本
+ *   - 每个元素带入队时间戳，接收时得到排队延迟
+ * 发送端只允许一个任务（或同一时刻只有一个任务调用），接收端同理。
+ */
+
+typedef struct flow_ctrl *flow_ctrl_handle_t;
+
+/**
+ * @brief  队列满（或处于背压）时的降载策略
+ */
+typedef enum {
+    FLOW_SHED_DROP_NEWEST = 0,  // 丢弃新数据（保留已排队的旧数据）
+    FLOW_SHED_DROP_OLDEST,      // 丢弃最旧的数据，为新数据腾出位置（延迟最小）
+    FLOW_SHED_DOWNSAMPLE,       // 背压期间按抽取倍数只接收第 N 个样本，仍满时丢弃新数据
+} flow_shed_policy_t;
+
+/**
+ * @brief  发送结果
+ */
+typedef enum {
+    FLOW_SEND_OK = 0,          // 已入队
+    FLOW_SEND_REPLACED_OLDEST, // 已入队，但丢弃了一个最旧的元素
+    FLOW_SEND_DROPPED,         // 队列满，新数据被丢弃
+    FLOW_SEND_DECIMATED,       // 被抽取跳过（DOWNSAMPLE）
+} flow_send_result_t;
+
+/**
+ * @brief  背压状态变化回调（在发送任务中调用，不能阻塞）
+ */
+typedef void (*flow_pressure_cb_t)(bool under_pressure, void *user_ctx);
+
+/**
+ * @brief  流控通道配置
+ */
+typedef struct {
+    size_t item_size;            // 元素大小（字节）
+    uint32_t capacity;           // 队列长度
+    uint32_t high_watermark;     // 深度 >= 该值进入背压（0 表示 capacity * 3 / 4）
+    uint32_t low_watermark;      // 深度 <= 该值解除背压（0 表示 high_watermark / 3）
+    flow_shed_policy_t policy;   // 降载策略
+    uint32_t max_decimation;     // 最大抽取倍数（0 表示 8）
+    flow_pressure_cb_t on_pressure; // 背压回调，可为 NULL
+    void *user_ctx;              // 回调参数
+} flow_ctrl_config_t;
+
+/**
+ * @brief  流控统计
+ */
+typedef struct {
+    uint32_t offered;           // 生产者提交的总数
+    uint32_t sent;              // 入队成功数
+    uint32_t received;          // 消费者取出数
+    uint32_t dropped_newest;    // 因队列满丢弃的新数据
+    uint32_t dropped_oldest;    // 为新数据腾位置丢弃的旧数据
+    uint32_t decimated;         // 被抽取跳过的数据
+    float drop_rate;            // (丢弃 + 抽取) / 提交
+    uint32_t pressure_events;   // 进入背压的次数
+    bool under_pressure;        // 当前是否处于背压
+    uint32_t decimation;        // 当前抽取倍数（1 表示不抽取）
+    uint32_t depth;             // 当前队列深度
+    uint32_t peak_depth;        // 队列深度峰值
+    uint32_t latency_avg_us;    // 平均排队延迟
+    uint32_t latency_max_us;    // 最大排队延迟
+} flow_ctrl_stats_t;
+
+/**
+ * @brief  创建流控通道
+ */
+esp_err_t flow_ctrl_create(const flow_ctrl_config_t *config, flow_ctrl_handle_t *ret_handle);
+
+/**
+ * @brief  删除流控通道（调用前停止收发任务）
+ */
+void flow_ctrl_delete(flow_ctrl_handle_t handle);
+
+/**
+ * @brief  提交一个元素，不阻塞
+ */
+flow_send_result_t flow_ctrl_send(flow_ctrl_handle_t handle, const void *item);
+
+/**
+ * @brief  取出一个元素
+ * @param  latency_us  输出排队延迟（微秒），可为 NULL
+ * @return 取到元素返回 true，超时返回 false
+ */
+bool flow_ctrl_receive(flow_ctrl_handle_t handle, void *item, TickType_t timeout, uint32_t *latency_us);
+
+/**
+ * @brief  当前抽取倍数：生产者可把采样周期乘以该值来自适应降速
+ */
+uint32_t flow_ctrl_get_decimation(flow_ctrl_handle_t handle);
+
+/**
+ * @brief  是否处于背压状态
+ */
+bool flow_ctrl_under_pressure(flow_ctrl_handle_t handle);
+
+/**
+ * @brief  底层队列（用于跟踪命名等调试用途，不要直接收发）
+ */
+QueueHandle_t flow_ctrl_get_queue(flow_ctrl_handle_t handle);
+
+/**
+ * @brief  读取统计
+ */
+void flow_ctrl_get_stats(flow_ctrl_handle_t handle, flow_ctrl_stats_t *stats);
+
+/**
+ * @brief  清零统计（不影响队列内容和背压状态）
+ */
+void flow_ctrl_reset_stats(flow_ctrl_handle_t handle);
+
+/**
+ * @brief  用 ESP_LOGI 打印统计
+ */
+void flow_ctrl_log_stats(flow_ctrl_handle_t handle, const char *name);
+
+/**
+ * @brief  策略名称
+ */
+const char *flow_ctrl_policy_name(flow_shed_policy_t policy);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 二进制遥测：把周期性的汇总日志换成紧凑的二进制帧，经控制台（UART / USB-CDC）输出。
+ *   消息体 = 头部（版本、类型、序号、毫秒时间戳）+ 负载（小端序字段）+ CRC-16/CCITT-FALSE
+ *   线上帧 = 0x00 + COBS(消息体) + 0x00
+ * COBS 编码后的数据不含 0x00，前后两个 0x00 作为分隔符，与普通文本日志混在同一个控制台上时，
+ * 主机端（tools/telemetry_decode.py）按 0x00 切分即可重新同步，校验失败的片段按文本处理。
+ * 负载格式由 TELEMETRY_SCHEMA_VERSION 标识：新增消息类型或在负载末尾追加字段时版本不变
+ * （解码器忽略多余字节），修改已有字段时必须增加版本号，并同步修改 telemetry_decode.py。
+ */
+
+#define TELEMETRY_SCHEMA_VERSION  1
+#define TELEMETRY_HEADER_SIZE     8     // 版本(1) + 类型(1) + 序号(2) + 时间戳(4)
+#define TELEMETRY_MAX_PAYLOAD     200
+#define TELEMETRY_MAX_BODY        (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + 2)
+// COBS 每 254 字节最多增加 1 字节，再加前后分隔符
+#define TELEMETRY_MAX_FRAME       (TELEMETRY_MAX_BODY + TELEMETRY_MAX_BODY / 254 + 1 + 2)
+#define TELEMETRY_MAX_TASKS       8     // 一条任务消息最多携带的任务数
+#define TELEMETRY_MAX_COUNTERS    16    // 一条计数器消息最多携带的计数器数
+
+/**
+ * @brief  消息类型（负载格式见各项注释，u8/u16/u32/f32 均为小端序，str 为 u8 长度 + 字节）
+ */
+typedef enum {
+    TELEMETRY_MSG_CHIP_INFO = 1, // str 目标芯片，u8 核数，u32 特性位，u16 版本，u32 flash 字节数
+    TELEMETRY_MSG_SENSOR = 2,    // u32 累计采样数，f32 平均温度，f32 平均湿度
+    TELEMETRY_MSG_HEAP = 3,      // u32 当前空闲堆，u32 历史最小空闲堆
+    TELEMETRY_MSG_TASKS = 4,     // u8 任务数，每个任务：str 名称，u8 优先级，u32 栈剩余高水位
+    TELEMETRY_MSG_COUNTERS = 5,  // u8 计数器组，u8 个数，每个 u32（各组的字段顺序见 telemetry_counters_t）
+    TELEMETRY_MSG_EVENT = 6,     // u16 事件代码，i32 参数
+} telemetry_msg_type_t;
+
+/**
+ * @brief  计数器组（TELEMETRY_MSG_COUNTERS 的第一个字段）
+ */
+typedef enum {
+    // offered, sent, received, dropped_newest, dropped_oldest, decimated, pressure_events,
+    // decimation, depth, peak_depth, latency_avg_us, latency_max_us（与 flow_ctrl_stats_t 同序）
+    TELEMETRY_COUNTERS_FLOW = 1,
+    // conversions, frames, blocks, overrun_frames, resyncs（与 acq_stats_t 同序）
+    TELEMETRY_COUNTERS_ACQ = 2,
+} telemetry_counters_t;
+
+/**
+ * @brief  事件代码（TELEMETRY_MSG_EVENT）
+ */
+typedef enum {
+    TELEMETRY_EVENT_RESTART_COUNTDOWN = 1, // 参数：距重启的秒数（0 表示立即重启）
+} telemetry_event_t;
+
+/**
+ * @brief  芯片信息（TELEMETRY_MSG_CHIP_INFO）
+ */
+typedef struct {
+    const char *target;      // CONFIG_IDF_TARGET
+    uint8_t cores;
+    uint32_t features;       // esp_chip_info_t::features
+    uint16_t revision;       // esp_chip_info_t::revision（主版本 * 100 + 次版本）
+    uint32_t flash_size;     // 字节
+} telemetry_chip_info_t;
+
+/**
+ * @brief  正在编码的消息（放在调用者的栈上，多个任务可以同时编码各自的消息）
+ */
+typedef struct {
+    uint8_t body[TELEMETRY_MAX_BODY];
+    size_t len;
+    bool overflow;           // 负载超过 TELEMETRY_MAX_PAYLOAD，消息不会被发送
+} telemetry_msg_t;
+
+/**
+ * @brief  帧输出回调（返回写入的字节数，出错返回负数）
+ */
+typedef int (*telemetry_write_fn_t)(const void *data, size_t len, void *ctx);
+
+/**
+ * @brief  遥测统计
+ */
+typedef struct {
+    uint32_t frames;         // 已输出的帧数
+    uint32_t bytes;          // 已输出的字节数（含 COBS 开销与分隔符）
+    uint32_t errors;         // 负载溢出或写入失败的消息数
+} telemetry_stats_t;
+
+/**
+ * @brief  设置帧输出回调（默认写到 stdout，即控制台 UART / USB-CDC）
+ * @param  write_fn  输出回调，NULL 恢复默认
+ * @param  ctx       回调参数
+ * @note   回调可能被多个任务同时调用，需要保证单次调用写出的帧不被其它输出打断
+ */
+void telemetry_set_sink(telemetry_write_fn_t write_fn, void *ctx);
+
+/**
+ * @brief  开始编码一条消息：写入头部并分配序号
+ */
+void telemetry_msg_begin(telemetry_msg_t *msg, telemetry_msg_type_t type);
+
+void telemetry_put_u8(telemetry_msg_t *msg, uint8_t value);
+void telemetry_put_u16(telemetry_msg_t *msg, uint16_t value);
+void telemetry_put_u32(telemetry_msg_t *msg, uint32_t value);
+void telemetry_put_f32(telemetry_msg_t *msg, float value);
+
+/**
+ * @brief  写入字符串（u8 长度 + 字节，超过 255 字节截断）
+ */
+void telemetry_put_str(telemetry_msg_t *msg, const char *str);
+
+/**
+ * @brief  追加 CRC 并做 COBS 编码，得到完整的线上帧（不输出）
+ * @param  msg    已写完负载的消息（调用后不能再追加字段）
+ * @param  frame  输出缓冲区，至少 TELEMETRY_MAX_FRAME 字节
+ * @return 帧长度；消息溢出时返回 0
+ */
+size_t telemetry_msg_finish(telemetry_msg_t *msg, uint8_t *frame);
+
+/**
+ * @brief  编码并通过输出回调发送消息（整帧一次写出）
+ * @return
+ *     - ESP_OK                 成功
+ *     - ESP_ERR_INVALID_SIZE   负载超过 TELEMETRY_MAX_PAYLOAD
+ *     - ESP_FAIL               写入失败
+ */
+esp_err_t telemetry_msg_send(telemetry_msg_t *msg);
+
+/**
+ * @brief  发送芯片信息
+ */
+esp_err_t telemetry_send_chip_info(const telemetry_chip_info_t *info);
+
+/**
+ * @brief  发送传感器汇总
+ */
+esp_err_t telemetry_send_sensor(uint32_t sample_count, float temp_avg, float humi_avg);
+
+/**
+ * @brief  发送当前空闲堆与历史最小空闲堆
+ */
+esp_err_t telemetry_send_heap(void);
+
+/**
+ * @brief  发送任务的名称、优先级和栈剩余高水位
+ * @param  tasks  任务句柄数组（NULL 项跳过，超过 TELEMETRY_MAX_TASKS 的部分忽略）
+ */
+esp_err_t telemetry_send_tasks(const TaskHandle_t *tasks, size_t count);
+
+/**
+ * @brief  发送一组计数器（超过 TELEMETRY_MAX_COUNTERS 的部分忽略）
+ */
+esp_err_t telemetry_send_counters(telemetry_counters_t group, const uint32_t *values, size_t count);
+
+/**
+ * @brief  发送事件
+ */
+esp_err_t telemetry_send_event(telemetry_event_t code, int32_t arg);
+
+/**
+ * @brief  获取统计信息
+ */
+void telemetry_get_stats(telemetry_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "telemetry.h"
+
+static telemetry_write_fn_t s_write_fn;
+static void *s_write_ctx;
+static uint16_t s_seq;
+static telemetry_stats_t s_stats;
+
+#define TELEMETRY_STAT_ADD(field, n)  __atomic_fetch_add(&s_stats.field, (n), __ATOMIC_RELAXED)
+
+// CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF），半字节查表
+static const uint16_t s_crc16_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+
+static uint16_t telemetry_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = (uint16_t)(crc << 4) ^ s_crc16_table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (uint16_t)(crc << 4) ^ s_crc16_table[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+// COBS 编码：输出不含 0x00，返回编码后长度（最多 len + len / 254 + 1）
+static size_t telemetry_cobs_encode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t code_pos = 0;
+    size_t out_pos = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] != 0) {
+            out[out_pos++] = in[i];
+            code++;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[code_pos] = code;
+            code_pos = out_pos++;
+            code = 1;
+        }
+    }
+    out[code_pos] = code;
+    return out_pos;
+}
+
+static int telemetry_stdout_write(const void *data, size_t len, void *ctx)
+{
+    // 整帧一次 fwrite，stdout 的锁保证不会和其它任务的输出交织
+    size_t written = fwrite(data, 1, len, stdout);
+    fflush(stdout);
+    return (int)written;
+}
+
+void telemetry_set_sink(telemetry_write_fn_t write_fn, void *ctx)
+{
+    s_write_ctx = ctx;
+    s_write_fn = write_fn;
+}
+
+// ====================== 消息编码 ======================
+static inline uint8_t *telemetry_reserve(telemetry_msg_t *msg, size_t n)
+{
+    if (msg->len + n > TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD) {
+        msg->overflow = true;
+        return NULL;
+    }
+    uint8_t *p = &msg->body[msg->len];
+    msg->len += n;
+    return p;
+}
+
+void telemetry_msg_begin(telemetry_msg_t *msg, telemetry_msg_type_t type)
+{
+    uint16_t seq = __atomic_fetch_add(&s_seq, 1, __ATOMIC_RELAXED);
+    uint32_t timestamp = esp_log_timestamp();
+    msg->len = 0;
+    msg->overflow = false;
+    telemetry_put_u8(msg, TELEMETRY_SCHEMA_VERSION);
+    telemetry_put_u8(msg, (uint8_t)type);
+    telemetry_put_u16(msg, seq);
+    telemetry_put_u32(msg, timestamp);
+}
+
+void telemetry_put_u8(telemetry_msg_t *msg, uint8_t value)
+{
+    uint8_t *p = telemetry_reserve(msg, 1);
+    if (p != NULL) {
+        p[0] = value;
+    }
+}
+
+void telemetry_put_u16(telemetry_msg_t *msg, uint16_t value)
+{
+    uint8_t *p = telemetry_reserve(msg, 2);
+    if (p != NULL) {
+        p[0] = (uint8_t)value;
+        p[1] = (uint8_t)(value >> 8);
+    }
+}
+
+void telemetry_put_u32(telemetry_msg_t *msg, uint32_t value)
+{
+    uint8_t *p = telemetry_reserve(msg, 4);
+    if (p != NULL) {
+        p[0] = (uint8_t)value;
+        p[1] = (uint8_t)(value >> 8);
+        p[2] = (uint8_t)(value >> 16);
+        p[3] = (uint8_t)(value >> 24);
+    }
+}
+
+void telemetry_put_f32(telemetry_msg_t *msg, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    telemetry_put_u32(msg, bits);
+}
+
+void telemetry_put_str(telemetry_msg_t *msg, const char *str)
+{
+    size_t len = str != NULL ? strlen(str) : 0;
+    if (len > UINT8_MAX) {
+        len = UINT8_MAX;
+    }
+    telemetry_put_u8(msg, (uint8_t)len);
+    uint8_t *p = telemetry_reserve(msg, len);
+    if (p != NULL && len > 0) {
+        memcpy(p, str, len);
+    }
+}
+
+size_t telemetry_msg_finish(telemetry_msg_t *msg, uint8_t *frame)
+{
+    if (msg->overflow) {
+        return 0;
+    }
+    // CRC 不受负载上限约束，body 末尾预留了 2 字节
+    uint16_t crc = telemetry_crc16(msg->body, msg->len);
+    msg->body[msg->len++] = (uint8_t)crc;
+    msg->body[msg->len++] = (uint8_t)(crc >> 8);
+
+    frame[0] = 0x00;
+    size_t len = 1 + telemetry_cobs_encode(msg->body, msg->len, &frame[1]);
+    frame[len++] = 0x00;
+    return len;
+}
+
+esp_err_t telemetry_msg_send(telemetry_msg_t *msg)
+{
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    size_t len = telemetry_msg_finish(msg, frame);
+    if (len == 0) {
+        TELEMETRY_STAT_ADD(errors, 1);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    telemetry_write_fn_t write_fn = s_write_fn != NULL ? s_write_fn : telemetry_stdout_write;
+    if (write_fn(frame, len, s_write_ctx) != (int)len) {
+        TELEMETRY_STAT_ADD(errors, 1);
+        return ESP_FAIL;
+    }
+    TELEMETRY_STAT_ADD(frames, 1);
+    TELEMETRY_STAT_ADD(bytes, len);
+    return ESP_OK;
+}
+
+// ====================== 预定义消息 ======================
+esp_err_t telemetry_send_chip_info(const telemetry_chip_info_t *info)
+{
+    telemetry_msg_t msg;
+    telemetry_msg_begin(&msg, TELEMETRY_MSG_CHIP_INFO);
+    telemetry_put_str(&msg, info->target);
+    telemetry_put_u8(&msg, info->cores);
+    telemetry_put_u32(&msg, info->features);
+    telemetry_put_u16(&msg, info->revision);
+    telemetry_put_u32(&msg, info->flash_size);
+    return telemetry_msg_send(&msg);
+}
+
+esp_err_t telemetry_send_sensor(uint32_t sample_count, float temp_avg, float humi_avg)
+{
+    telemetry_msg_t msg;
+    telemetry_msg_begin(&msg, TELEMETRY_MSG_SENSOR);
+    telemetry_put_u32(&msg, sample_count);
+    telemetry_put_f32(&msg, temp_avg);
+    telemetry_put_f32(&msg, humi_avg);
+    return telemetry_msg_send(&msg);
+}
+
+esp_err_t telemetry_send_heap(void)
+{
+    telemetry_msg_t msg;
+    telemetry_msg_begin(&msg, TELEMETRY_MSG_HEAP);
+    telemetry_put_u32(&msg, esp_get_free_heap_size());
+    telemetry_put_u32(&msg, esp_get_minimum_free_heap_size());
+    return telemetry_msg_send(&msg);
+}
+
+esp_err_t telemetry_send_tasks(const TaskHandle_t *tasks, size_t count)
+{
+    telemetry_msg_t msg;
+    uint8_t n = 0;
+    telemetry_msg_begin(&msg, TELEMETRY_MSG_TASKS);
+    size_t count_pos = msg.len;
+    telemetry_put_u8(&msg, 0);  // 任务数，写完后回填
+    for (size_t i = 0; i < count && n < TELEMETRY_MAX_TASKS; i++) {
+        if (tasks[i] == NULL) {
+            continue;
+        }
+        telemetry_put_str(&msg, pcTaskGetName(tasks[i]));
+        telemetry_put_u8(&msg, (uint8_t)uxTaskPriorityGet(tasks[i]));
+        telemetry_put_u32(&msg, (uint32_t)uxTaskGetStackHighWaterMark(tasks[i]));
+        n++;
+    }
+    msg.body[count_pos] = n;
+    return telemetry_msg_send(&msg);
+}
+
+esp_err_t telemetry_send_counters(telemetry_counters_t group, const uint32_t *values, size_t count)
+{
+    telemetry_msg_t msg;
+    if (count > TELEMETRY_MAX_COUNTERS) {
+        count = TELEMETRY_MAX_COUNTERS;
+    }
+    telemetry_msg_begin(&msg, TELEMETRY_MSG_COUNTERS);
+    telemetry_put_u8(&msg, (uint8_t)group);
+    telemetry_put_u8(&msg, (uint8_t)count);
+    for (size_t i = 0; i < count; i++) {
+        telemetry_put_u32(&msg, values[i]);
+    }
+    return telemetry_msg_send(&msg);
+}
+
+esp_err_t telemetry_send_event(telemetry_event_t code, int32_t arg)
+{
+    telemetry_msg_t msg;
+    telemetry_msg_begin(&msg, TELEMETRY_MSG_EVENT);
+    telemetry_put_u16(&msg, (uint16_t)code);
+    telemetry_put_u32(&msg, (uint32_t)arg);
+    return telemetry_msg_send(&msg);
+}
+
+void telemetry_get_stats(telemetry_stats_t *stats)
+{
+    stats->frames = __atomic_load_n(&s_stats.frames, __ATOMIC_RELAXED);
+    stats->bytes = __atomic_load_n(&s_stats.bytes, __ATOMIC_RELAXED);
+    stats->errors = __atomic_load_n(&s_stats.errors, __ATOMIC_RELAXED);
+}
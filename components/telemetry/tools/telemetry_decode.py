@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: CC0-1.0
+"""
+解码 telemetry 组件输出的二进制遥测帧（0x00 + COBS(消息体 + CRC16) + 0x00）。
+
+输入可以是串口原始数据（idf.py monitor 的日志文件、串口抓包）或 linux 目标的标准输出，
+二进制帧与普通文本日志可以混在一起：按 0x00 切分，能通过 CRC 校验的片段解码为消息，
+其余片段作为文本原样保留。
+
+用法：
+    python telemetry_decode.py capture.bin            # 每条消息输出一行 JSON
+    python telemetry_decode.py capture.bin --text     # 同时输出夹在帧之间的文本日志
+也可以作为库使用：Decoder().feed(data) 返回解码出的 Message 列表。
+"""
+import argparse
+import binascii
+import json
+import struct
+import sys
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Tuple
+
+# 与 telemetry.h 保持一致
+SCHEMA_VERSION = 1
+HEADER = struct.Struct('<BBHI')  # 版本、类型、序号、毫秒时间戳
+
+MSG_CHIP_INFO = 1
+MSG_SENSOR = 2
+MSG_HEAP = 3
+MSG_TASKS = 4
+MSG_COUNTERS = 5
+MSG_EVENT = 6
+
+MSG_NAMES = {
+    MSG_CHIP_INFO: 'chip_info',
+    MSG_SENSOR: 'sensor',
+    MSG_HEAP: 'heap',
+    MSG_TASKS: 'tasks',
+    MSG_COUNTERS: 'counters',
+    MSG_EVENT: 'event',
+}
+
+COUNTER_GROUPS = {
+    1: ('flow', ['offered', 'sent', 'received', 'dropped_newest', 'dropped_oldest', 'decimated',
+                 'pressure_events', 'decimation', 'depth', 'peak_depth', 'latency_avg_us', 'latency_max_us']),
+    2: ('acq', ['conversions', 'frames', 'blocks', 'overrun_frames', 'resyncs']),
+}
+
+EVENT_NAMES = {
+    1: 'restart_countdown',
+}
+
+
+@dataclass
+class Message:
+    type: int
+    name: str
+    seq: int
+    timestamp_ms: int
+    fields: Dict[str, Any] = field(default_factory=dict)
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {'type': self.name, 'seq': self.seq, 'timestamp_ms': self.timestamp_ms, **self.fields}
+
+
+class _Reader:
+    def __init__(self, data: bytes) -> None:
+        self.data = data
+        self.offset = 0
+
+    def unpack(self, fmt: str) -> Any:
+        value = struct.unpack_from('<' + fmt, self.data, self.offset)
+        self.offset += struct.calcsize('<' + fmt)
+        return value[0] if len(value) == 1 else value
+
+    def string(self) -> str:
+        length = self.unpack('B')
+        raw = self.data[self.offset:self.offset + length]
+        if len(raw) != length:
+            raise struct.error('字符串越界')
+        self.offset += length
+        return raw.decode('utf-8', errors='replace')
+
+
+def crc16(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF），与 telemetry.c 相同"""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def cobs_decode(data: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError('COBS 编码错误')
+        out.extend(data[i + 1:i + code])
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def _decode_payload(msg_type: int, r: _Reader) -> Dict[str, Any]:
+    # 负载末尾多出的字节是新版本追加的字段，忽略
+    if msg_type == MSG_CHIP_INFO:
+        target = r.string()
+        cores, features, revision, flash_size = r.unpack('BIHI')
+        return {'target': target, 'cores': cores, 'features': features,
+                'revision': f'v{revision // 100}.{revision % 100}', 'flash_size': flash_size}
+    if msg_type == MSG_SENSOR:
+        sample_count, temp_avg, humi_avg = r.unpack('Iff')
+        return {'sample_count': sample_count, 'temp_avg': round(temp_avg, 3), 'humi_avg': round(humi_avg, 3)}
+    if msg_type == MSG_HEAP:
+        free, minimum = r.unpack('II')
+        return {'free_heap': free, 'min_free_heap': minimum}
+    if msg_type == MSG_TASKS:
+        tasks = []
+        for _ in range(r.unpack('B')):
+            name = r.string()
+            priority, stack_hwm = r.unpack('BI')
+            tasks.append({'name': name, 'priority': priority, 'stack_hwm': stack_hwm})
+        return {'tasks': tasks}
+    if msg_type == MSG_COUNTERS:
+        group, count = r.unpack('BB')
+        values = [r.unpack('I') for _ in range(count)]
+        group_name, names = COUNTER_GROUPS.get(group, (f'group{group}', []))
+        counters = {names[i] if i < len(names) else f'c{i}': v for i, v in enumerate(values)}
+        return {'group': group_name, 'counters': counters}
+    if msg_type == MSG_EVENT:
+        code, arg = r.unpack('Hi')
+        return {'event': EVENT_NAMES.get(code, f'event{code}'), 'arg': arg}
+    return {'payload': r.data[r.offset:].hex()}
+
+
+def decode_body(body: bytes) -> Message:
+    """解码一条消息体（COBS 解码后的数据，含末尾 CRC）；校验失败抛出 ValueError"""
+    if len(body) < HEADER.size + 2:
+        raise ValueError('消息过短')
+    payload, crc = body[:-2], struct.unpack_from('<H', body, len(body) - 2)[0]
+    if crc16(payload) != crc:
+        raise ValueError('CRC 错误')
+    version, msg_type, seq, timestamp_ms = HEADER.unpack_from(payload, 0)
+    if version != SCHEMA_VERSION:
+        raise ValueError(f'不支持的版本 {version}')
+    try:
+        fields = _decode_payload(msg_type, _Reader(payload[HEADER.size:]))
+    except struct.error as e:
+        raise ValueError(f'负载长度错误：{e}') from e
+    return Message(msg_type, MSG_NAMES.get(msg_type, f'type{msg_type}'), seq, timestamp_ms, fields)
+
+
+def decode_frame(chunk: bytes) -> Message:
+    """解码两个 0x00 之间的一段数据；控制台把 \\n 扩展成 \\r\\n 时先还原再试一次"""
+    try:
+        return decode_body(cobs_decode(chunk))
+    except ValueError:
+        if b'\r\n' not in chunk:
+            raise
+        return decode_body(cobs_decode(chunk.replace(b'\r\n', b'\n')))
+
+
+class Decoder:
+    """流式解码：可以分多次喂入任意长度的数据"""
+
+    def __init__(self) -> None:
+        self._pending = bytearray()
+        self.text = bytearray()      # 不是遥测帧的数据（普通文本日志）
+        self.frames = 0
+        self.bad_chunks = 0          # 像帧但校验失败的片段（也计入 text）
+
+    def feed(self, data: bytes) -> List[Message]:
+        messages = []
+        self._pending.extend(data)
+        *chunks, rest = bytes(self._pending).split(b'\x00')
+        self._pending = bytearray(rest)
+        for chunk in chunks:
+            if not chunk:
+                continue
+            try:
+                messages.append(decode_frame(chunk))
+                self.frames += 1
+            except ValueError:
+                if not _looks_like_text(chunk):
+                    self.bad_chunks += 1
+                self.text.extend(chunk)
+        return messages
+
+    def flush(self) -> None:
+        """输入结束：剩余不完整的数据作为文本"""
+        self.text.extend(self._pending)
+        self._pending.clear()
+
+
+def _looks_like_text(chunk: bytes) -> bool:
+    try:
+        return chunk.decode('utf-8').isprintable() or b'\n' in chunk
+    except UnicodeDecodeError:
+        return False
+
+
+def decode_stream(data: bytes) -> Tuple[List[Message], bytes]:
+    decoder = Decoder()
+    messages = decoder.feed(data)
+    decoder.flush()
+    return messages, bytes(decoder.text)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='串口抓包 / 日志文件（- 表示标准输入）')
+    parser.add_argument('--text', action='store_true', help='同时输出帧之间的文本日志')
+    args = parser.parse_args()
+
+    data = sys.stdin.buffer.read() if args.input == '-' else open(args.input, 'rb').read()
+    decoder = Decoder()
+    for msg in decoder.feed(data):
+        print(json.dumps(msg.to_dict(), ensure_ascii=False))
+    decoder.flush()
+    if args.text and decoder.text:
+        sys.stdout.write(decoder.text.decode('utf-8', errors='replace'))
+    print(f'{decoder.frames} 条消息，{decoder.bad_chunks} 个校验失败的片段', file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_err.h"
+#include "trace_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  导出数据的写入回调（返回写入的字节数，出错返回负数）
+ */
+typedef int (*trace_write_fn_t)(const void *data, size_t len, void *ctx);
+
+/**
+ * @brief  跟踪统计信息
+ */
+typedef struct {
+    uint32_t recorded[CONFIG_FREERTOS_NUMBER_OF_CORES]; // 每核累计写入的事件数
+    uint32_t overwritten;                               // 被覆盖（丢失）的事件总数
+    uint32_t names;                                     // 已登记的名称数
+} trace_stats_t;
+
+/**
+ * @brief  一个核的记录窗口（trace_visit 回调参数）
+ */
+typedef struct {
+    int core;           // 核号
+    uint32_t ts_hz;     // 时间戳频率
+    uint32_t start_ts;  // trace_start() 时刻
+    uint32_t end_ts;    // trace_stop() 时刻
+    uint32_t lost;      // 被覆盖的事件数（非 0 时窗口开头的事件不完整）
+} trace_core_info_t;
+
+/**
+ * @brief  遍历回调：每个核的事件按时间顺序给出，该核遍历完后再以 event == NULL 调用一次
+ */
+typedef void (*trace_visit_fn_t)(const trace_core_info_t *core, const trace_event_t *event, void *ctx);
+
+#if CONFIG_TRACE_ENABLE
+
+/**
+ * @brief  用户区间/中断/计数器的名称（用 TRACE_LABEL_DEFINE 在文件作用域定义）
+ */
+typedef struct trace_label {
+    const char *name;
+    uint32_t id;                // trace_start() 时分配，之前为 0
+    struct trace_label *next;
+} trace_label_t;
+
+/**
+ * @brief  登记一个名称，trace_start() 时为它分配 id（由 TRACE_LABEL_DEFINE 生成的构造函数调用）
+ */
+void trace_label_register(trace_label_t *label);
+
+/**
+ * @brief  清空缓冲区并开始记录（记录各核时间戳锚点，用于多核对齐）
+ */
+void trace_start(void);
+
+/**
+ * @brief  停止记录（缓冲区内容保留，可随后导出）
+ */
+void trace_stop(void);
+
+/**
+ * @brief  为对象（队列、信号量、中断等）登记一个名称
+ * @param  id    对象标识，通常为 TRACE_ID(handle)
+ * @param  name  名称（超过 15 个字符会被截断）
+ */
+void trace_register_name(uint32_t id, const char *name);
+
+/**
+ * @brief  为用户区间/中断/计数器分配名称 id（同名返回同一个 id）
+ */
+uint32_t trace_name_id(const char *name);
+
+/**
+ * @brief  按二进制格式导出所有缓冲区（导出前会先停止记录）
+ */
+esp_err_t trace_dump(trace_write_fn_t write_fn, void *ctx);
+
+/**
+ * @brief  在设备上直接遍历缓冲区中的事件（遍历前会先停止记录），不导出也能统计任务切换等
+ */
+esp_err_t trace_visit(trace_visit_fn_t visit_fn, void *ctx);
+
+/**
+ * @brief  以十六进制文本导出到控制台（TRACE_BEGIN / TRACE: ... / TRACE_END）
+ */
+esp_err_t trace_dump_to_console(void);
+
+/**
+ * @brief  导出到文件（linux 目标直接写主机文件；芯片上需要先挂载文件系统）
+ */
+esp_err_t trace_dump_to_file(const char *path);
+
+/**
+ * @brief  读取统计信息
+ */
+void trace_get_stats(trace_stats_t *stats);
+
+/*
+ * 用户埋点。名称先在文件作用域定义（启动时由构造函数登记，trace_start() 时分配 id）：
+ *
+ *   TRACE_LABEL_DEFINE(s_trace_collect, "collect");
+ *   ...
+ *   TRACE_SPAN_BEGIN(s_trace_collect);
+ *
+ * 埋点处只读取 id 并写入事件，不查找名称表，中断中同样适用。
+ */
+#define TRACE_LABEL_DEFINE(label, name_str)                                         \
+    static trace_label_t label = { .name = (name_str) };                           \
+    __attribute__((constructor)) static void label##_register_(void)                \
+    {                                                                               \
+        trace_label_register(&label);                                               \
+    }                                                                               \
+    _Static_assert(1, "")  // 吃掉宏调用处的分号
+
+#define TRACE_SPAN_BEGIN(label)      trace_record(TRACE_EVT_SPAN_BEGIN, (label).id, 0)
+#define TRACE_SPAN_END(label)        trace_record(TRACE_EVT_SPAN_END, (label).id, 0)
+#define TRACE_MARK(label)            trace_record(TRACE_EVT_MARK, (label).id, 0)
+#define TRACE_COUNTER(label, value)  trace_record(TRACE_EVT_COUNTER, (label).id, (uint16_t)(value))
+#define TRACE_ISR_ENTER(label)       trace_record(TRACE_EVT_ISR_ENTER, (label).id, 0)
+#define TRACE_ISR_EXIT(label)        trace_record(TRACE_EVT_ISR_EXIT, (label).id, 0)
+#define TRACE_NAME(handle, name)     trace_register_name(TRACE_ID(handle), name)
+
+#else // !CONFIG_TRACE_ENABLE
+
+static inline void trace_start(void) {}
+static inline void trace_stop(void) {}
+static inline esp_err_t trace_visit(trace_visit_fn_t visit_fn, void *ctx) { (void)visit_fn; (void)ctx; return ESP_ERR_NOT_SUPPORTED; }
+static inline esp_err_t trace_dump_to_console(void) { return ESP_ERR_NOT_SUPPORTED; }
+static inline esp_err_t trace_dump_to_file(const char *path) { (void)path; return ESP_ERR_NOT_SUPPORTED; }
+
+#define TRACE_LABEL_DEFINE(label, name_str)  _Static_assert(1, "")
+#define TRACE_SPAN_BEGIN(label)     do {} while (0)
+#define TRACE_SPAN_END(label)       do {} while (0)
+#define TRACE_MARK(label)           do {} while (0)
+#define TRACE_COUNTER(label, value) do { (void)(value); } while (0)
+#define TRACE_ISR_ENTER(label)      do {} while (0)
+#define TRACE_ISR_EXIT(label)       do {} while (0)
+#define TRACE_NAME(handle, name)    do { (void)(handle); } while (0)
+
+#endif // CONFIG_TRACE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+/*
+ * 跟踪事件的二进制格式（设备端与 tools/trace2perfetto.py 共用）
+ * 本文件会被强制包含进 FreeRTOS 内核，只允许依赖标准头文件。
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACE_FILE_MAGIC    0x43525445u  // "ETRC"
+#define TRACE_FILE_VERSION  1
+
+/**
+ * @brief  事件类型
+ */
+typedef enum {
+    TRACE_EVT_TASK_SWITCH_IN = 1,   // 任务切入，id=任务句柄
+    TRACE_EVT_ISR_ENTER,            // 进入中断，id=中断名称 id
+    TRACE_EVT_ISR_EXIT,             // 退出中断
+    TRACE_EVT_QUEUE_SEND,           // 队列发送/信号量释放，id=队列句柄，arg=发送后队列深度
+    TRACE_EVT_QUEUE_SEND_FAILED,    // 队列满，发送失败
+    TRACE_EVT_QUEUE_SEND_FROM_ISR,  // 中断中发送/释放
+    TRACE_EVT_QUEUE_RECEIVE,        // 队列接收/信号量获取，arg=接收后队列深度
+    TRACE_EVT_QUEUE_RECEIVE_FAILED, // 接收超时
+    TRACE_EVT_QUEUE_BLOCK,          // 因队列空/满进入阻塞
+    TRACE_EVT_SPAN_BEGIN,           // 用户区间开始，id=区间名称 id
+    TRACE_EVT_SPAN_END,             // 用户区间结束
+    TRACE_EVT_MARK,                 // 用户瞬时事件
+    TRACE_EVT_COUNTER,              // 用户计数器，arg=数值
+} trace_evt_type_t;
+
+/**
+ * @brief  单个事件（12 字节，小端）
+ */
+typedef struct {
+    uint32_t ts;    // 时间戳（芯片上为 CPU 周期计数，linux 为微秒；频率见文件头 ts_hz，32 位回绕由主机端展开）
+    uint8_t type;   // trace_evt_type_t
+    uint8_t flags;  // 保留
+    uint16_t arg;   // 附加参数
+    uint32_t id;    // 对象标识（句柄地址低 32 位或名称 id）
+} trace_event_t;
+
+/**
+ * @brief  写入一个事件（任务/中断上下文均可调用，每核无锁）
+ */
+void trace_record(uint8_t type, uint32_t id, uint16_t arg);
+
+/**
+ * @brief  登记任务名称（FreeRTOS 任务创建钩子调用）
+ */
+void trace_hook_task_create(void *task);
+
+/**
+ * @brief  任务切入（FreeRTOS 任务切换钩子调用）
+ */
+void trace_hook_task_switched_in(void);
+
+#define TRACE_ID(ptr)  ((uint32_t)(uintptr_t)(ptr))
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+/*
+ * FreeRTOS trace 宏实现
+ *
+ * FreeRTOS.h 只在宏未定义时才把 traceXXX 定义为空，所以这个头文件必须在
+ * FreeRTOS 内核之前生效。在工程 CMakeLists.txt（project() 之前）加入：
+ *
+ *   idf_build_set_property(C_COMPILE_OPTIONS
+ *       "-include${CMAKE_CURRENT_LIST_DIR}/../components/trace/include/trace_freertos_hooks.h" APPEND)
+ *
+ * 宏在 queue.c/tasks.c 内部展开，因此可以直接访问 Queue_t 的成员。
+ */
+
+#include "sdkconfig.h"
+
+#if CONFIG_TRACE_FREERTOS_HOOKS
+
+#include "trace_event.h"
+
+#define TRACE_QUEUE_DEPTH_(q)  ((uint16_t)(q)->uxMessagesWaiting)
+
+#define traceTASK_CREATE(pxNewTCB)              trace_hook_task_create(pxNewTCB)
+#define traceTASK_SWITCHED_IN()                 trace_hook_task_switched_in()
+
+#define traceQUEUE_SEND(pxQueue)                trace_record(TRACE_EVT_QUEUE_SEND, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue) + 1)
+#define traceQUEUE_SEND_FAILED(pxQueue)         trace_record(TRACE_EVT_QUEUE_SEND_FAILED, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       trace_record(TRACE_EVT_QUEUE_SEND_FROM_ISR, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue) + 1)
+#define traceQUEUE_GIVE_FROM_ISR(pxQueue)       trace_record(TRACE_EVT_QUEUE_SEND_FROM_ISR, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue) + 1)
+#define traceQUEUE_RECEIVE(pxQueue)             trace_record(TRACE_EVT_QUEUE_RECEIVE, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue) - 1)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)      trace_record(TRACE_EVT_QUEUE_RECEIVE_FAILED, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    trace_record(TRACE_EVT_QUEUE_BLOCK, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) trace_record(TRACE_EVT_QUEUE_BLOCK, TRACE_ID(pxQueue), TRACE_QUEUE_DEPTH_(pxQueue))
+
+#endif // CONFIG_TRACE_FREERTOS_HOOKS
@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: CC0-1.0
+"""
+把 trace 组件导出的二进制事件转换成 Perfetto / Chrome trace JSON。
+
+输入可以是 trace_dump_to_file() 写出的 .bin 文件，也可以是包含
+TRACE_BEGIN / TRACE:<hex> / TRACE_END 的串口日志（取最后一段）。
+
+用法：
+    python trace2perfetto.py monitor.log -o trace.json
+然后在 https://ui.perfetto.dev 或 chrome://tracing 中打开 trace.json。
+"""
+import argparse
+import json
+import struct
+import sys
+from collections import defaultdict, deque
+from dataclasses import dataclass, field
+from typing import Deque, Dict, List, Optional, Tuple
+
+TRACE_FILE_MAGIC = 0x43525445
+TRACE_FILE_VERSION = 1
+
+# 与 trace_event.h 中的 trace_evt_type_t 保持一致
+TASK_SWITCH_IN = 1
+ISR_ENTER = 2
+ISR_EXIT = 3
+QUEUE_SEND = 4
+QUEUE_SEND_FAILED = 5
+QUEUE_SEND_FROM_ISR = 6
+QUEUE_RECEIVE = 7
+QUEUE_RECEIVE_FAILED = 8
+QUEUE_BLOCK = 9
+SPAN_BEGIN = 10
+SPAN_END = 11
+MARK = 12
+COUNTER = 13
+
+EVENT_NAMES = {
+    TASK_SWITCH_IN: 'task_switch_in',
+    ISR_ENTER: 'isr_enter',
+    ISR_EXIT: 'isr_exit',
+    QUEUE_SEND: 'queue_send',
+    QUEUE_SEND_FAILED: 'queue_send_failed',
+    QUEUE_SEND_FROM_ISR: 'queue_send_from_isr',
+    QUEUE_RECEIVE: 'queue_receive',
+    QUEUE_RECEIVE_FAILED: 'queue_receive_failed',
+    QUEUE_BLOCK: 'queue_block',
+    SPAN_BEGIN: 'span_begin',
+    SPAN_END: 'span_end',
+    MARK: 'mark',
+    COUNTER: 'counter',
+}
+
+NAME_KIND_OBJECT = 1
+NAME_KIND_LABEL = 2
+
+HEADER = struct.Struct('<IHHIHH')
+NAME = struct.Struct('<IB3x16s')
+CORE_HEADER = struct.Struct('<IIIIq')
+EVENT = struct.Struct('<IBBHI')
+
+TASKS_PID = 100  # 所有任务轨道放在同一个“进程”下
+
+
+@dataclass
+class Event:
+    time_us: float
+    core: int
+    type: int
+    arg: int
+    id: int
+
+
+@dataclass
+class Trace:
+    ts_hz: int
+    num_cores: int
+    objects: Dict[int, str] = field(default_factory=dict)
+    labels: Dict[int, str] = field(default_factory=dict)
+    events: List[Event] = field(default_factory=list)
+    lost: List[int] = field(default_factory=list)
+
+
+def extract_binary(raw: bytes) -> bytes:
+    """从串口日志中取出最后一段 TRACE: 十六进制数据；本身是二进制则原样返回"""
+    if raw[:4] == struct.pack('<I', TRACE_FILE_MAGIC):
+        return raw
+    blocks: List[bytearray] = []
+    current: Optional[bytearray] = None
+    for line in raw.decode('utf-8', errors='replace').splitlines():
+        if 'TRACE_BEGIN' in line:
+            current = bytearray()
+        elif 'TRACE_END' in line and current is not None:
+            blocks.append(current)
+            current = None
+        elif current is not None and 'TRACE:' in line:
+            current.extend(bytes.fromhex(line.split('TRACE:', 1)[1].strip()))
+    if not blocks:
+        raise ValueError('输入中没有找到 TRACE_BEGIN/TRACE_END 数据段')
+    return bytes(blocks[-1])
+
+
+def parse_trace(data: bytes) -> Trace:
+    magic, version, event_size, ts_hz, num_cores, num_names = HEADER.unpack_from(data, 0)
+    if magic != TRACE_FILE_MAGIC or version != TRACE_FILE_VERSION or event_size != EVENT.size:
+        raise ValueError(f'不支持的跟踪数据：magic=0x{magic:08x} version={version} event_size={event_size}')
+    trace = Trace(ts_hz=ts_hz, num_cores=num_cores)
+    offset = HEADER.size
+
+    for _ in range(num_names):
+        obj_id, kind, raw_name = NAME.unpack_from(data, offset)
+        offset += NAME.size
+        name = raw_name.split(b'\0', 1)[0].decode('utf-8', errors='replace')
+        if kind == NAME_KIND_LABEL:
+            trace.labels[obj_id] = name
+        elif kind == NAME_KIND_OBJECT:
+            trace.objects[obj_id] = name
+        # kind 为 0 表示导出时该条目还没写完，直接跳过
+
+    for core in range(num_cores):
+        count, lost, end_ts, _, end_us = CORE_HEADER.unpack_from(data, offset)
+        offset += CORE_HEADER.size
+        raw_events = [EVENT.unpack_from(data, offset + i * EVENT.size) for i in range(count)]
+        offset += count * EVENT.size
+        trace.lost.append(lost)
+
+        # 时间戳是 32 位计数器：从停止时的锚点倒推展开回绕，并换算成与其它核一致的微秒时间轴
+        ticks = 0
+        prev_ts = end_ts
+        times: List[float] = []
+        for ts, *_ in reversed(raw_events):
+            delta = (prev_ts - ts) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            ticks -= delta
+            prev_ts = ts
+            times.append(end_us + ticks * 1e6 / ts_hz)
+        times.reverse()
+        for time_us, (_, evt_type, _, arg, obj_id) in zip(times, raw_events):
+            trace.events.append(Event(time_us, core, evt_type, arg, obj_id))
+
+    trace.events.sort(key=lambda e: (e.time_us, e.core))
+    return trace
+
+
+def to_chrome_trace(trace: Trace) -> dict:
+    """生成 Chrome trace JSON（Perfetto 可直接打开）"""
+    out: List[dict] = []
+    origin = trace.events[0].time_us if trace.events else 0.0
+
+    def ts(evt: Event) -> float:
+        return round(evt.time_us - origin, 3)
+
+    def object_name(obj_id: int) -> str:
+        return trace.objects.get(obj_id, f'0x{obj_id:08x}')
+
+    def label_name(label_id: int) -> str:
+        return trace.labels.get(label_id, f'#{label_id}')
+
+    task_tids: Dict[int, int] = {}
+
+    def task_tid(task_id: int) -> int:
+        if task_id not in task_tids:
+            task_tids[task_id] = len(task_tids) + 1
+            out.append({'ph': 'M', 'name': 'thread_name', 'pid': TASKS_PID, 'tid': task_tids[task_id],
+                        'args': {'name': object_name(task_id)}})
+        return task_tids[task_id]
+
+    out.append({'ph': 'M', 'name': 'process_name', 'pid': TASKS_PID, 'args': {'name': 'Tasks'}})
+    for core in range(trace.num_cores):
+        out.append({'ph': 'M', 'name': 'process_name', 'pid': core, 'args': {'name': f'CPU{core}'}})
+        out.append({'ph': 'M', 'name': 'thread_name', 'pid': core, 'tid': 0, 'args': {'name': 'running'}})
+        out.append({'ph': 'M', 'name': 'thread_name', 'pid': core, 'tid': 1, 'args': {'name': 'ISR'}})
+
+    running: Dict[int, Tuple[int, float]] = {}   # core -> (任务, 切入时间)
+    isr_stack: Dict[int, List[int]] = defaultdict(list)
+    pending_flows: Dict[int, Deque[int]] = defaultdict(deque)
+    next_flow = 1
+
+    def close_slice(core: int, end: Event) -> None:
+        if core in running:
+            task_id, start = running.pop(core)
+            dur = round(end.time_us - start, 3)
+            name = object_name(task_id)
+            out.append({'ph': 'X', 'name': name, 'pid': core, 'tid': 0, 'ts': round(start - origin, 3), 'dur': dur})
+            out.append({'ph': 'X', 'name': f'running@CPU{core}', 'pid': TASKS_PID, 'tid': task_tid(task_id),
+                        'ts': round(start - origin, 3), 'dur': dur})
+
+    def track(evt: Event) -> Tuple[int, int]:
+        """事件发生在哪条轨道：中断中 → CPU 的 ISR 轨道，否则 → 当前任务轨道"""
+        if isr_stack[evt.core]:
+            return evt.core, 1
+        if evt.core in running:
+            return TASKS_PID, task_tid(running[evt.core][0])
+        return evt.core, 0
+
+    for evt in trace.events:
+        name = EVENT_NAMES.get(evt.type, f'type{evt.type}')
+        if evt.type == TASK_SWITCH_IN:
+            if evt.core in running and running[evt.core][0] == evt.id:
+                continue
+            close_slice(evt.core, evt)
+            running[evt.core] = (evt.id, evt.time_us)
+            task_tid(evt.id)
+        elif evt.type == ISR_ENTER:
+            isr_stack[evt.core].append(evt.id)
+            out.append({'ph': 'B', 'name': label_name(evt.id), 'pid': evt.core, 'tid': 1, 'ts': ts(evt)})
+        elif evt.type == ISR_EXIT:
+            if isr_stack[evt.core]:
+                isr_stack[evt.core].pop()
+                out.append({'ph': 'E', 'pid': evt.core, 'tid': 1, 'ts': ts(evt)})
+        elif evt.type in (SPAN_BEGIN, SPAN_END):
+            pid, tid = track(evt)
+            out.append({'ph': 'B' if evt.type == SPAN_BEGIN else 'E', 'name': label_name(evt.id),
+                        'pid': pid, 'tid': tid, 'ts': ts(evt)})
+        elif evt.type == MARK:
+            pid, tid = track(evt)
+            out.append({'ph': 'i', 's': 't', 'name': label_name(evt.id), 'pid': pid, 'tid': tid, 'ts': ts(evt)})
+        elif evt.type == COUNTER:
+            out.append({'ph': 'C', 'name': label_name(evt.id), 'pid': TASKS_PID, 'ts': ts(evt),
+                        'args': {'value': evt.arg}})
+        else:
+            # 队列/信号量/互斥锁操作：瞬时事件 + 队列深度计数器 + 发送→接收的流向箭头
+            pid, tid = track(evt)
+            queue = object_name(evt.id)
+            out.append({'ph': 'i', 's': 't', 'name': f'{name} {queue}', 'pid': pid, 'tid': tid, 'ts': ts(evt),
+                        'args': {'depth': evt.arg}})
+            if evt.type in (QUEUE_SEND, QUEUE_SEND_FROM_ISR, QUEUE_RECEIVE):
+                out.append({'ph': 'C', 'name': f'depth {queue}', 'pid': TASKS_PID, 'ts': ts(evt),
+                            'args': {'depth': evt.arg}})
+            if evt.type in (QUEUE_SEND, QUEUE_SEND_FROM_ISR):
+                pending_flows[evt.id].append(next_flow)
+                out.append({'ph': 's', 'name': queue, 'cat': 'queue', 'id': next_flow,
+                            'pid': pid, 'tid': tid, 'ts': ts(evt)})
+                next_flow += 1
+            elif evt.type == QUEUE_RECEIVE and pending_flows[evt.id]:
+                out.append({'ph': 'f', 'bp': 'e', 'name': queue, 'cat': 'queue', 'id': pending_flows[evt.id].popleft(),
+                            'pid': pid, 'tid': tid, 'ts': ts(evt)})
+
+    if trace.events:
+        last = trace.events[-1]
+        for core in list(running):
+            close_slice(core, last)
+
+    return {'traceEvents': out, 'displayTimeUnit': 'ns',
+            'otherData': {'ts_hz': trace.ts_hz, 'lost_events': trace.lost}}
+
+
+def summarize(trace: Trace) -> Dict[str, int]:
+    """按事件类型统计数量（测试与命令行摘要共用）"""
+    counts: Dict[str, int] = defaultdict(int)
+    for evt in trace.events:
+        counts[EVENT_NAMES.get(evt.type, f'type{evt.type}')] += 1
+    return dict(counts)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='trace 二进制事件 → Perfetto/Chrome trace JSON')
+    parser.add_argument('input', help='trace_dump_to_file() 生成的 .bin 或含 TRACE: 行的串口日志')
+    parser.add_argument('-o', '--output', default='trace.json', help='输出 JSON 文件')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        trace = parse_trace(extract_binary(f.read()))
+    with open(args.output, 'w', encoding='utf-8') as f:
+        json.dump(to_chrome_trace(trace), f, ensure_ascii=False)
+
+    print(f'{len(trace.events)} 个事件，{trace.num_cores} 个核，丢失 {sum(trace.lost)} 个', file=sys.stderr)
+    for name, count in sorted(summarize(trace).items()):
+        print(f'  {name:<22}{count}', file=sys.stderr)
+    print(f'已写入 {args.output}', file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
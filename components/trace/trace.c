@@ -0,0 +1,407 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "trace.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#if CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+#include "esp_ipc.h"
+#endif
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+static const char *TAG = "trace";
+
+// ====================== 平台相关：时间戳与核号 ======================
+#if CONFIG_IDF_TARGET_LINUX
+// linux 目标使用单调时钟的微秒数：32 位约 71 分钟回绕一次，稀疏的跟踪（事件间隔超过 2 秒）也能正确展开
+#define TRACE_TS_HZ  1000000u
+
+static inline int64_t trace_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline uint32_t trace_now(void)
+{
+    return (uint32_t)trace_now_us();
+}
+
+#define TRACE_CORE_ID()  0
+#else
+// CPU 周期计数器（CCOUNT/mcycle）只需一条指令；开启动态调频时时间轴会失真
+#define TRACE_TS_HZ      (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000u)
+#define trace_now()      esp_cpu_get_cycle_count()
+#define trace_now_us()   esp_timer_get_time()
+#define TRACE_CORE_ID()  esp_cpu_get_core_id()
+#endif
+
+#define TRACE_NUM_CORES   CONFIG_FREERTOS_NUMBER_OF_CORES
+#define TRACE_BUF_MASK    (CONFIG_TRACE_BUFFER_EVENTS - 1)
+#define TRACE_NAME_LEN    16
+
+_Static_assert((CONFIG_TRACE_BUFFER_EVENTS & TRACE_BUF_MASK) == 0, "TRACE_BUFFER_EVENTS 必须是 2 的幂");
+_Static_assert(sizeof(trace_event_t) == 12, "trace_event_t 必须保持 12 字节");
+
+// ====================== 导出文件格式（小端，与 tools/trace2perfetto.py 保持一致） ======================
+typedef struct {
+    uint32_t magic;        // TRACE_FILE_MAGIC
+    uint16_t version;      // TRACE_FILE_VERSION
+    uint16_t event_size;   // sizeof(trace_event_t)
+    uint32_t ts_hz;        // 时间戳频率
+    uint16_t num_cores;    // 核数（后面跟 num_cores 个核段）
+    uint16_t num_names;    // 名称表条目数
+} trace_file_header_t;
+
+typedef enum {
+    TRACE_NAME_KIND_FREE = 0,
+    TRACE_NAME_KIND_OBJECT,  // 任务/队列等句柄
+    TRACE_NAME_KIND_LABEL,   // trace_name_id() 分配的名称 id
+} trace_name_kind_t;
+
+typedef struct {
+    uint32_t id;
+    uint8_t kind;
+    uint8_t reserved[3];
+    char name[TRACE_NAME_LEN];
+} trace_name_t;
+
+typedef struct {
+    uint32_t count;   // 本段事件数
+    uint32_t lost;    // 被覆盖的事件数
+    uint32_t end_ts;  // 停止记录时的时间戳（主机端据此展开 32 位回绕）
+    uint32_t reserved;
+    int64_t end_us;   // 同一时刻的 esp_timer 微秒数（用于多核时间轴对齐）
+} trace_core_header_t;
+
+// ====================== 每核环形缓冲区 ======================
+typedef struct {
+    uint32_t head;        // 累计写入数（下标 = head & TRACE_BUF_MASK）
+    uint32_t start_ts;
+    uint32_t end_ts;
+    int64_t end_us;
+    trace_event_t events[CONFIG_TRACE_BUFFER_EVENTS];
+} trace_core_buf_t;
+
+static trace_core_buf_t s_bufs[TRACE_NUM_CORES];
+static trace_name_t s_names[CONFIG_TRACE_MAX_NAMES];
+static uint32_t s_name_count = 0;
+static uint32_t s_next_label_id = 1;
+static trace_label_t *s_labels = NULL;  // TRACE_LABEL_DEFINE 定义的名称，trace_start() 时统一分配 id
+static volatile bool s_enabled = false;
+
+/**
+ * @brief  写入一个事件
+ * @note   屏蔽本核中断后只访问本核缓冲区，任务与中断嵌套都安全，不需要自旋锁
+ */
+void IRAM_ATTR trace_record(uint8_t type, uint32_t id, uint16_t arg)
+{
+    if (!s_enabled) {
+        return;
+    }
+    UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+    trace_core_buf_t *buf = &s_bufs[TRACE_CORE_ID()];
+    trace_event_t *evt = &buf->events[buf->head++ & TRACE_BUF_MASK];
+    evt->ts = trace_now();
+    evt->type = type;
+    evt->flags = 0;
+    evt->arg = arg;
+    evt->id = id;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+}
+
+// ====================== 名称表（无锁追加） ======================
+static void trace_copy_name(char *dst, const char *src)
+{
+    // 不用 strlcpy：linux 目标使用主机 libc，旧版 glibc 没有这个函数
+    strncpy(dst, src, TRACE_NAME_LEN - 1);
+    dst[TRACE_NAME_LEN - 1] = '\0';
+}
+
+static trace_name_t *trace_find_name(uint8_t kind, uint32_t id, const char *name)
+{
+    uint32_t count = __atomic_load_n(&s_name_count, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < count && i < CONFIG_TRACE_MAX_NAMES; i++) {
+        trace_name_t *entry = &s_names[i];
+        if (__atomic_load_n(&entry->kind, __ATOMIC_ACQUIRE) != kind) {
+            continue;
+        }
+        if (name != NULL ? strncmp(entry->name, name, TRACE_NAME_LEN - 1) == 0 : entry->id == id) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void trace_add_name(uint8_t kind, uint32_t id, const char *name)
+{
+    uint32_t slot = __atomic_fetch_add(&s_name_count, 1, __ATOMIC_ACQ_REL);
+    if (slot >= CONFIG_TRACE_MAX_NAMES) {
+        return; // 名称表已满，导出后只显示地址
+    }
+    trace_name_t *entry = &s_names[slot];
+    entry->id = id;
+    trace_copy_name(entry->name, name);
+    __atomic_store_n(&entry->kind, kind, __ATOMIC_RELEASE); // 最后写 kind，读者看到时内容已完整
+}
+
+void trace_register_name(uint32_t id, const char *name)
+{
+    trace_name_t *entry = trace_find_name(TRACE_NAME_KIND_OBJECT, id, NULL);
+    if (entry != NULL) {
+        // 句柄被复用（例如任务删除后重建），更新为新名称
+        trace_copy_name(entry->name, name);
+        return;
+    }
+    trace_add_name(TRACE_NAME_KIND_OBJECT, id, name);
+}
+
+uint32_t trace_name_id(const char *name)
+{
+    trace_name_t *entry = trace_find_name(TRACE_NAME_KIND_LABEL, 0, name);
+    if (entry != NULL) {
+        return entry->id;
+    }
+    uint32_t id = __atomic_fetch_add(&s_next_label_id, 1, __ATOMIC_RELAXED);
+    trace_add_name(TRACE_NAME_KIND_LABEL, id, name);
+    return id;
+}
+
+void trace_label_register(trace_label_t *label)
+{
+    // 由启动阶段的构造函数调用（此时只有一个执行流），不需要加锁
+    label->next = s_labels;
+    s_labels = label;
+}
+
+// ====================== FreeRTOS 钩子 ======================
+#if CONFIG_TRACE_FREERTOS_HOOKS
+void trace_hook_task_create(void *task)
+{
+    // 在记录开始前也登记名称，这样 IDLE/main 等启动阶段创建的任务同样有名字
+    trace_register_name(TRACE_ID(task), pcTaskGetName((TaskHandle_t)task));
+}
+
+void IRAM_ATTR trace_hook_task_switched_in(void)
+{
+    trace_record(TRACE_EVT_TASK_SWITCH_IN, TRACE_ID(xTaskGetCurrentTaskHandle()), 0);
+}
+#endif
+
+// ====================== 开始/停止 ======================
+static void trace_capture_start_anchor(void *arg)
+{
+    (void)arg;
+    s_bufs[TRACE_CORE_ID()].start_ts = trace_now();
+}
+
+static void trace_capture_end_anchor(void *arg)
+{
+    (void)arg;
+    UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+    trace_core_buf_t *buf = &s_bufs[TRACE_CORE_ID()];
+    buf->end_ts = trace_now();
+    buf->end_us = trace_now_us();
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+}
+
+void trace_start(void)
+{
+    s_enabled = false;
+    for (int core = 0; core < TRACE_NUM_CORES; core++) {
+        s_bufs[core].head = 0;
+    }
+    // 预先登记所有区间/中断/计数器名称，埋点处只读取 id，中断里不再查找名称表
+    for (trace_label_t *label = s_labels; label != NULL; label = label->next) {
+        if (label->id == 0) {
+            label->id = trace_name_id(label->name);
+        }
+    }
+    trace_capture_start_anchor(NULL);
+    s_enabled = true;
+#if !CONFIG_IDF_TARGET_LINUX && CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+    // 另一个核在开启记录后再取起点：IPC 任务的切入/切出会被记录，此后该核正在运行的任务就是已知的
+    esp_ipc_call_blocking(!xPortGetCoreID(), trace_capture_start_anchor, NULL);
+#endif
+    ESP_LOGI(TAG, "开始记录，每核缓冲 %d 个事件（%u 字节）",
+             CONFIG_TRACE_BUFFER_EVENTS, (unsigned)sizeof(s_bufs[0].events));
+}
+
+void trace_stop(void)
+{
+    if (!s_enabled) {
+        return;
+    }
+    s_enabled = false;
+    trace_capture_end_anchor(NULL);
+#if !CONFIG_IDF_TARGET_LINUX && CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+    // 另一个核的周期计数器独立运行，需要在那个核上各取一次锚点
+    esp_ipc_call_blocking(!xPortGetCoreID(), trace_capture_end_anchor, NULL);
+#endif
+}
+
+void trace_get_stats(trace_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (int core = 0; core < TRACE_NUM_CORES; core++) {
+        uint32_t head = s_bufs[core].head;
+        stats->recorded[core] = head;
+        if (head > CONFIG_TRACE_BUFFER_EVENTS) {
+            stats->overwritten += head - CONFIG_TRACE_BUFFER_EVENTS;
+        }
+    }
+    uint32_t names = s_name_count;
+    stats->names = names < CONFIG_TRACE_MAX_NAMES ? names : CONFIG_TRACE_MAX_NAMES;
+}
+
+// ====================== 导出 ======================
+#define TRACE_WRITE(data, len) do {                         \
+        if (write_fn((data), (len), ctx) != (int)(len)) {   \
+            return ESP_FAIL;                                \
+        }                                                   \
+    } while (0)
+
+esp_err_t trace_dump(trace_write_fn_t write_fn, void *ctx)
+{
+    if (write_fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    trace_stop();
+
+    trace_stats_t stats;
+    trace_get_stats(&stats);
+
+    trace_file_header_t header = {
+        .magic = TRACE_FILE_MAGIC,
+        .version = TRACE_FILE_VERSION,
+        .event_size = sizeof(trace_event_t),
+        .ts_hz = TRACE_TS_HZ,
+        .num_cores = TRACE_NUM_CORES,
+        .num_names = stats.names,
+    };
+    TRACE_WRITE(&header, sizeof(header));
+    TRACE_WRITE(s_names, sizeof(trace_name_t) * stats.names);
+
+    for (int core = 0; core < TRACE_NUM_CORES; core++) {
+        const trace_core_buf_t *buf = &s_bufs[core];
+        uint32_t count = buf->head < CONFIG_TRACE_BUFFER_EVENTS ? buf->head : CONFIG_TRACE_BUFFER_EVENTS;
+        trace_core_header_t core_header = {
+            .count = count,
+            .lost = buf->head - count,
+            .end_ts = buf->end_ts,
+            .end_us = buf->end_us,
+        };
+        TRACE_WRITE(&core_header, sizeof(core_header));
+
+        // 从最旧的事件开始按时间顺序导出（环形缓冲区可能分成两段）
+        uint32_t first = (buf->head - count) & TRACE_BUF_MASK;
+        uint32_t tail_len = count < CONFIG_TRACE_BUFFER_EVENTS - first ? count : CONFIG_TRACE_BUFFER_EVENTS - first;
+        TRACE_WRITE(&buf->events[first], sizeof(trace_event_t) * tail_len);
+        TRACE_WRITE(&buf->events[0], sizeof(trace_event_t) * (count - tail_len));
+    }
+    return ESP_OK;
+}
+
+esp_err_t trace_visit(trace_visit_fn_t visit_fn, void *ctx)
+{
+    if (visit_fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    trace_stop();
+
+    for (int core = 0; core < TRACE_NUM_CORES; core++) {
+        const trace_core_buf_t *buf = &s_bufs[core];
+        uint32_t count = buf->head < CONFIG_TRACE_BUFFER_EVENTS ? buf->head : CONFIG_TRACE_BUFFER_EVENTS;
+        trace_core_info_t info = {
+            .core = core,
+            .ts_hz = TRACE_TS_HZ,
+            .start_ts = buf->start_ts,
+            .end_ts = buf->end_ts,
+            .lost = buf->head - count,
+        };
+        for (uint32_t i = buf->head - count; i != buf->head; i++) {
+            visit_fn(&info, &buf->events[i & TRACE_BUF_MASK], ctx);
+        }
+        visit_fn(&info, NULL, ctx);
+    }
+    return ESP_OK;
+}
+
+// 控制台导出：每行 32 字节的十六进制，便于从串口日志中截取
+#define TRACE_HEX_LINE_BYTES  32
+
+typedef struct {
+    uint8_t line[TRACE_HEX_LINE_BYTES];
+    size_t fill;
+    size_t total;
+} trace_hex_writer_t;
+
+static void trace_hex_flush(trace_hex_writer_t *writer)
+{
+    if (writer->fill == 0) {
+        return;
+    }
+    char text[TRACE_HEX_LINE_BYTES * 2 + 1];
+    for (size_t i = 0; i < writer->fill; i++) {
+        sprintf(&text[i * 2], "%02x", writer->line[i]);
+    }
+    printf("TRACE:%s\n", text);
+    writer->fill = 0;
+}
+
+static int trace_hex_write(const void *data, size_t len, void *ctx)
+{
+    trace_hex_writer_t *writer = (trace_hex_writer_t *)ctx;
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        writer->line[writer->fill++] = bytes[i];
+        if (writer->fill == TRACE_HEX_LINE_BYTES) {
+            trace_hex_flush(writer);
+        }
+    }
+    writer->total += len;
+    return (int)len;
+}
+
+esp_err_t trace_dump_to_console(void)
+{
+    trace_hex_writer_t writer = {0};
+    printf("TRACE_BEGIN\n");
+    esp_err_t ret = trace_dump(trace_hex_write, &writer);
+    trace_hex_flush(&writer);
+    printf("TRACE_END %u\n", (unsigned)writer.total);
+    fflush(stdout);
+    return ret;
+}
+
+static int trace_file_write(const void *data, size_t len, void *ctx)
+{
+    return (int)fwrite(data, 1, len, (FILE *)ctx);
+}
+
+esp_err_t trace_dump_to_file(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "无法打开文件：%s", path);
+        return ESP_FAIL;
+    }
+    esp_err_t ret = trace_dump(trace_file_write, f);
+    fclose(f);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "跟踪数据已写入：%s", path);
+    }
+    return ret;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  唤醒原因
+ */
+typedef enum {
+    WAKE_CAUSE_TIMER = 0,  // 定时器到期（vTaskDelay、esp_timer、轮询周期）
+    WAKE_CAUSE_GPIO,       // GPIO 电平/边沿
+    WAKE_CAUSE_TOUCH,      // 触摸传感器
+    WAKE_CAUSE_OTHER,      // 其它（UART、未知）
+    WAKE_CAUSE_MAX,
+} wake_cause_t;
+
+/**
+ * @brief  电源管理配置
+ */
+typedef struct {
+    int max_freq_mhz;        // 有任务运行时的最高 CPU 频率
+    int min_freq_mhz;        // 空闲时降到的频率
+    bool light_sleep_enable; // 空闲时自动进入浅睡眠（需要 CONFIG_FREERTOS_USE_TICKLESS_IDLE）
+} wake_mgr_config_t;
+
+#define WAKE_MGR_DEFAULT_CONFIG() {                         \
+    .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,        \
+    .min_freq_mhz = 40,                                     \
+    .light_sleep_enable = true,                             \
+}
+
+/**
+ * @brief  单个唤醒原因的统计
+ */
+typedef struct {
+    uint32_t wakeups;       // 自动浅睡眠被该原因唤醒的次数（硬件上报的唤醒原因，同时有多个原因时各计一次）
+    float wakeups_per_s;    // 每秒唤醒次数
+    uint64_t sleep_us;      // 以该原因结束的浅睡眠累计时长（同时有多个原因时计入每个原因，各原因之和可能大于总睡眠时长）
+} wake_mgr_cause_stats_t;
+
+/**
+ * @brief  唤醒统计
+ */
+typedef struct {
+    int64_t elapsed_us;                              // 统计时长
+    uint32_t sleep_exits;                            // 退出浅睡眠的总次数
+    uint64_t sleep_us;                               // 浅睡眠累计时长
+    float sleep_ratio;                               // 浅睡眠时间占比
+    wake_mgr_cause_stats_t causes[WAKE_CAUSE_MAX];
+} wake_mgr_stats_t;
+
+/**
+ * @brief  配置动态调频与自动浅睡眠，开始统计
+ * @param  config  电源管理配置，传 NULL 时只统计、不修改电源管理设置
+ * @note   唤醒统计来自浅睡眠退出回调（需要 CONFIG_PM_LIGHT_SLEEP_CALLBACKS）；
+ *         linux 目标没有浅睡眠，统计始终为 0
+ */
+esp_err_t wake_mgr_init(const wake_mgr_config_t *config);
+
+/**
+ * @brief  允许指定 GPIO 以电平方式唤醒浅睡眠
+ * @param  gpio_num    GPIO 编号
+ * @param  wake_level  唤醒电平（0 低电平，1 高电平），会同时把该引脚的中断改为同一电平触发
+ */
+esp_err_t wake_mgr_enable_gpio(int gpio_num, int wake_level);
+
+/**
+ * @brief  读取统计
+ */
+void wake_mgr_get_stats(wake_mgr_stats_t *stats);
+
+/**
+ * @brief  清零统计并重新开始计时
+ */
+void wake_mgr_reset_stats(void);
+
+/**
+ * @brief  用 ESP_LOGI 打印统计
+ */
+void wake_mgr_log_stats(void);
+
+/**
+ * @brief  唤醒原因名称
+ */
+const char *wake_mgr_cause_name(wake_cause_t cause);
+
+#ifdef __cplusplus
+}
+#endif
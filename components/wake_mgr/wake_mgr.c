@@ -0,0 +1,195 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "wake_mgr.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_bit_defs.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+static const char *TAG = "wake_mgr";
+
+static const char *s_cause_names[WAKE_CAUSE_MAX] = {
+    [WAKE_CAUSE_TIMER] = "timer",
+    [WAKE_CAUSE_GPIO] = "gpio",
+    [WAKE_CAUSE_TOUCH] = "touch",
+    [WAKE_CAUSE_OTHER] = "other",
+};
+
+// 计数只做原子加，两个核的浅睡眠回调可以并发写
+static struct {
+    int64_t start_us;
+    uint32_t wakeups[WAKE_CAUSE_MAX];
+    uint64_t cause_sleep_us[WAKE_CAUSE_MAX];
+    uint32_t sleep_exits;
+    uint64_t sleep_us;
+} s_stats;
+
+#if CONFIG_IDF_TARGET_LINUX
+static int64_t wake_mgr_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#else
+#define wake_mgr_now_us()  esp_timer_get_time()
+#endif
+
+#if !CONFIG_IDF_TARGET_LINUX && CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+// 硬件唤醒源到统计分类的映射（esp_sleep_get_wakeup_causes() 的位）
+#define WAKE_MGR_GPIO_CAUSES   (BIT(ESP_SLEEP_WAKEUP_GPIO) | BIT(ESP_SLEEP_WAKEUP_EXT0) | BIT(ESP_SLEEP_WAKEUP_EXT1))
+
+/**
+ * @brief  记一次某原因的唤醒，并把这次的睡眠时长计入该原因
+ */
+static inline void IRAM_ATTR wake_mgr_count(wake_cause_t cause, uint64_t sleep_time_us)
+{
+    __atomic_fetch_add(&s_stats.wakeups[cause], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s_stats.cause_sleep_us[cause], sleep_time_us, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief  浅睡眠退出回调：按硬件上报的唤醒原因计数，并累计睡眠时长
+ * @note   多个唤醒源可能同时触发，每个原因各计一次唤醒、各计入一次这段睡眠时长
+ */
+static esp_err_t IRAM_ATTR wake_mgr_on_sleep_exit(int64_t sleep_time_us, void *arg)
+{
+    (void)arg;
+    uint32_t causes = esp_sleep_get_wakeup_causes();
+    uint32_t known = 0;
+    if (causes & BIT(ESP_SLEEP_WAKEUP_TIMER)) {
+        wake_mgr_count(WAKE_CAUSE_TIMER, (uint64_t)sleep_time_us);
+        known |= BIT(ESP_SLEEP_WAKEUP_TIMER);
+    }
+    if (causes & WAKE_MGR_GPIO_CAUSES) {
+        wake_mgr_count(WAKE_CAUSE_GPIO, (uint64_t)sleep_time_us);
+        known |= WAKE_MGR_GPIO_CAUSES;
+    }
+    if (causes & BIT(ESP_SLEEP_WAKEUP_TOUCHPAD)) {
+        wake_mgr_count(WAKE_CAUSE_TOUCH, (uint64_t)sleep_time_us);
+        known |= BIT(ESP_SLEEP_WAKEUP_TOUCHPAD);
+    }
+    if ((causes & ~known) != 0 || causes == 0) {
+        wake_mgr_count(WAKE_CAUSE_OTHER, (uint64_t)sleep_time_us);
+    }
+    __atomic_fetch_add(&s_stats.sleep_exits, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s_stats.sleep_us, (uint64_t)sleep_time_us, __ATOMIC_RELAXED);
+    return ESP_OK;
+}
+#endif
+
+esp_err_t wake_mgr_init(const wake_mgr_config_t *config)
+{
+    wake_mgr_reset_stats();
+    if (config == NULL) {
+        return ESP_OK;
+    }
+
+#if CONFIG_IDF_TARGET_LINUX
+    ESP_LOGW(TAG, "linux 目标不支持电源管理，只统计唤醒次数");
+    return ESP_OK;
+#elif !CONFIG_PM_ENABLE
+    ESP_LOGE(TAG, "未开启 CONFIG_PM_ENABLE，无法自动浅睡眠");
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = config->max_freq_mhz,
+        .min_freq_mhz = config->min_freq_mhz,
+        .light_sleep_enable = config->light_sleep_enable,
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "电源管理配置失败：%s", esp_err_to_name(ret));
+        return ret;
+    }
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs_config = {
+        .exit_cb = wake_mgr_on_sleep_exit,
+    };
+    ret = esp_pm_light_sleep_register_cbs(&cbs_config);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "浅睡眠回调注册失败，睡眠时长无法统计：%s", esp_err_to_name(ret));
+    }
+#endif
+    ESP_LOGI(TAG, "动态调频 %d~%d MHz，自动浅睡眠：%s", config->min_freq_mhz, config->max_freq_mhz,
+             config->light_sleep_enable ? "开启" : "关闭");
+    return ESP_OK;
+#endif
+}
+
+esp_err_t wake_mgr_enable_gpio(int gpio_num, int wake_level)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    (void)gpio_num;
+    (void)wake_level;
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    // 浅睡眠只能用电平唤醒：该引脚的中断类型同时变为电平触发
+    esp_err_t ret = gpio_wakeup_enable(gpio_num, wake_level ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return esp_sleep_enable_gpio_wakeup();
+#endif
+}
+
+void wake_mgr_get_stats(wake_mgr_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->elapsed_us = wake_mgr_now_us() - s_stats.start_us;
+    float elapsed_s = stats->elapsed_us / 1e6f;
+
+    for (int i = 0; i < WAKE_CAUSE_MAX; i++) {
+        wake_mgr_cause_stats_t *cause = &stats->causes[i];
+        cause->wakeups = __atomic_load_n(&s_stats.wakeups[i], __ATOMIC_RELAXED);
+        cause->wakeups_per_s = elapsed_s > 0 ? cause->wakeups / elapsed_s : 0.0f;
+        cause->sleep_us = __atomic_load_n(&s_stats.cause_sleep_us[i], __ATOMIC_RELAXED);
+    }
+    stats->sleep_exits = __atomic_load_n(&s_stats.sleep_exits, __ATOMIC_RELAXED);
+    stats->sleep_us = __atomic_load_n(&s_stats.sleep_us, __ATOMIC_RELAXED);
+    stats->sleep_ratio = stats->elapsed_us > 0 ? (float)stats->sleep_us / stats->elapsed_us : 0.0f;
+}
+
+void wake_mgr_reset_stats(void)
+{
+    for (int i = 0; i < WAKE_CAUSE_MAX; i++) {
+        __atomic_store_n(&s_stats.wakeups[i], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s_stats.cause_sleep_us[i], 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&s_stats.sleep_exits, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_stats.sleep_us, 0, __ATOMIC_RELAXED);
+    s_stats.start_us = wake_mgr_now_us();
+}
+
+void wake_mgr_log_stats(void)
+{
+    wake_mgr_stats_t stats;
+    wake_mgr_get_stats(&stats);
+    ESP_LOGI(TAG, "统计 %.1f 秒，退出浅睡眠 %u 次，睡眠 %.1f 毫秒（占比 %.1f%%）", stats.elapsed_us / 1e6,
+             (unsigned)stats.sleep_exits, stats.sleep_us / 1000.0, stats.sleep_ratio * 100.0f);
+    for (int i = 0; i < WAKE_CAUSE_MAX; i++) {
+        const wake_mgr_cause_stats_t *cause = &stats.causes[i];
+        if (cause->wakeups == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-6s 唤醒 %.2f 次/秒（共 %u 次），之前睡眠 %.1f 毫秒",
+                 s_cause_names[i], cause->wakeups_per_s, (unsigned)cause->wakeups, cause->sleep_us / 1000.0);
+    }
+}
+
+const char *wake_mgr_cause_name(wake_cause_t cause)
+{
+    return cause < WAKE_CAUSE_MAX ? s_cause_names[cause] : "unknown";
+}
@@ -1,7 +1,11 @@
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "event_bus.h"
+#include "wake_mgr.h"
 
 // 宏定义：LED 连接的 GPIO 引脚（可修改为任意普通 GPIO，如 19、20（释放 JTAG 后）、2、4 等）
 #define LED_GPIO_PIN  2
@@ -14,6 +18,81 @@ static const char *TAG = "GPIO";
 // 宏定义：中断优先级（0~3，数值越小优先级越高，避免与系统高优先级中断冲突）
 #define KEY_INTR_PRIO  1
 
+// 定时器事件编号（EVENT_TOPIC_TIMER 的 id）
+#define TIMER_ID_LED_BLINK      1   // LED 闪烁周期
+#define TIMER_ID_KEY_DEBOUNCE   2   // 电平中断消抖
+#define TIMER_ID_KEY_CONFIRM    3   // 边沿中断按键确认
+
+#define LED_BLINK_PERIOD_US     (1000 * 1000)
+#define KEY_DEBOUNCE_US         (20 * 1000)
+#define KEY_CONFIRM_US          (50 * 1000)
+
+/*
+ * 按键、LED 闪烁都改为事件驱动：GPIO 中断和 esp_timer 把事件发布到同一个事件总线，
+ * 由总线的一个分发任务调用各自的处理函数。原先每个功能各占一个任务（按键检测、按键中断、LED 闪烁），
+ * 现在只剩一个分发任务；消抖也不再用 vTaskDelay 占住任务，而是启动一次性定时器，到期后再发布事件。
+ */
+static event_bus_handle_t s_bus = NULL;
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+/**
+ * @brief  esp_timer 回调（定时器中断中执行）：把定时器到期转成事件（arg 为定时器事件编号）
+ * @note   在中断中直接发布，到期时只唤醒事件总线的分发任务，不再先唤醒 esp_timer 任务
+ */
+static void IRAM_ATTR timer_event_callback(void *arg)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    event_bus_publish_from_isr(s_bus, EVENT_TOPIC_TIMER, (uint32_t)arg, 0, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+        esp_timer_isr_dispatch_need_yield();
+    }
+}
+#define TIMER_EVENT_DISPATCH  ESP_TIMER_ISR
+#else
+/**
+ * @brief  esp_timer 回调：把定时器到期转成事件（arg 为定时器事件编号）
+ * @note   未开启 CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD 时在 esp_timer 任务中执行，每次到期多一次任务唤醒
+ */
+static void timer_event_callback(void *arg)
+{
+    event_bus_publish(s_bus, EVENT_TOPIC_TIMER, (uint32_t)arg, 0);
+}
+#define TIMER_EVENT_DISPATCH  ESP_TIMER_TASK
+#endif
+
+/**
+ * @brief  创建发布定时器事件的 esp_timer
+ */
+static esp_timer_handle_t timer_event_create(uint32_t timer_id, const char *name)
+{
+    const esp_timer_create_args_t args = {
+        .callback = timer_event_callback,
+        .arg = (void *)timer_id,
+        .dispatch_method = TIMER_EVENT_DISPATCH,
+        .name = name,
+    };
+    esp_timer_handle_t timer = NULL;
+    esp_err_t ret = esp_timer_create(&args, &timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "定时器 %s 创建失败，错误码：%d", name, ret);
+    }
+    return timer;
+}
+
+/**
+ * @brief  创建事件总线（一个分发任务）
+ */
+esp_err_t gpio_event_bus_init(void)
+{
+    event_bus_config_t config = EVENT_BUS_DEFAULT_CONFIG();
+    config.capacity = 16;
+    esp_err_t ret = event_bus_create(&config, &s_bus);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "事件总线创建失败，错误码：%d", ret);
+    }
+    return ret;
+}
+
 /**
  * @brief  GPIO 输出模式初始化配置
  */
@@ -38,9 +117,74 @@ void gpio_output_init(void)
 
     // 4. 初始化电平：设置为低电平（LED 熄灭，根据硬件接线调整）
     gpio_set_level(LED_GPIO_PIN, 0);
+
+    // 5. 浅睡眠期间保持输出电平（默认睡眠时引脚会切换到睡眠配置，LED 会熄灭）
+    gpio_sleep_sel_dis(LED_GPIO_PIN);
     ESP_LOGI(TAG, "GPIO 输出模式初始化完成，引脚：%d", LED_GPIO_PIN);
 }
 
+static esp_timer_handle_t key_debounce_timer = NULL;
+static bool key_wakeup_enabled = false;  // 按键是否已注册为浅睡眠唤醒源（电源管理不可用时为 false）
+
+/**
+ * @brief  按键电平中断回调
+ * @note   电平中断在电平保持期间会持续触发，先关闭中断，由事件处理函数处理完再重新打开
+ */
+static void key_level_isr_handler(void *arg)
+{
+    gpio_intr_disable(KEY_GPIO_PIN);
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    event_bus_publish_from_isr(s_bus, EVENT_TOPIC_GPIO, KEY_GPIO_PIN, 0, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  按键状态检测（电平中断方式，在事件总线分发任务中执行）
+ * @note   原先每 20ms 轮询一次（每秒 50 次唤醒）；现在只在电平变化时被唤醒，
+ *         收到 GPIO 事件后启动 20ms 消抖定时器，到期的定时器事件中读取电平
+ */
+static void key_level_event_handler(const event_bus_event_t *events, size_t count, void *ctx)
+{
+    static uint32_t last_key_level = 1;  // 上一次按键电平状态，初始化为松开状态（上拉电阻+按键接GND）
+
+    for (size_t i = 0; i < count; i++) {
+        const event_bus_event_t *event = &events[i];
+        if (event->topic == EVENT_TOPIC_GPIO && event->id == KEY_GPIO_PIN) {
+            // 1. 电平中断（按下时为低电平中断，松开时为高电平中断）：开始消抖
+            esp_timer_start_once(key_debounce_timer, KEY_DEBOUNCE_US);
+        } else if (event->topic == EVENT_TOPIC_TIMER && event->id == TIMER_ID_KEY_DEBOUNCE) {
+            // 2. 消抖结束，读取 GPIO 输入电平（0：按下，1：松开）
+            uint32_t key_level = gpio_get_level(KEY_GPIO_PIN);
+
+            // 3. 检测按键状态变化（仅当电平变化时打印日志，避免重复输出）
+            if (key_level != last_key_level) {
+                if (key_level == 0) {
+                    ESP_LOGI(TAG, "按键按下（电平：%d）", (int)key_level);
+                } else {
+                    ESP_LOGI(TAG, "按键松开（电平：%d）", (int)key_level);
+                }
+                last_key_level = key_level;
+            }
+
+            // 4. 改为等待相反电平（按下后等松开，松开后等按下）；无论唤醒源是否可用都要切换，
+            //    否则按住按键期间电平中断会在每个消抖周期重复触发
+            gpio_set_intr_type(KEY_GPIO_PIN, key_level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+
+            // 5. 唤醒电平同步切换（单独检查，失败时不再作为唤醒源，只保留中断）
+            if (key_wakeup_enabled) {
+                esp_err_t ret = wake_mgr_enable_gpio(KEY_GPIO_PIN, !key_level);
+                if (ret != ESP_OK) {
+                    ESP_LOGW(TAG, "GPIO 唤醒电平切换失败，错误码：%d", ret);
+                    key_wakeup_enabled = false;
+                }
+            }
+
+            // 6. 重新打开中断
+            gpio_intr_enable(KEY_GPIO_PIN);
+        }
+    }
+}
+
 /**
  * @brief  GPIO 输入模式初始化配置
  */
@@ -50,7 +194,7 @@ void gpio_input_init(void)
     gpio_config_t io_conf = {0};
 
     // 2. 配置参数设置
-    io_conf.intr_type = GPIO_INTR_DISABLE;  // 禁用中断（轮询模式无需中断）
+    io_conf.intr_type = GPIO_INTR_LOW_LEVEL; // 低电平中断（按键按下），同时作为浅睡眠唤醒源
     io_conf.mode = GPIO_MODE_INPUT;         // 配置为输入模式
     io_conf.pin_bit_mask = (1ULL << KEY_GPIO_PIN);  // 选中要配置的 GPIO 引脚
     io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;  // 禁用下拉电阻
@@ -63,66 +207,103 @@ void gpio_input_init(void)
         return;
     }
 
+    // 4. 订阅按键与消抖定时器事件，注册电平中断
+    key_debounce_timer = timer_event_create(TIMER_ID_KEY_DEBOUNCE, "key_debounce");
+    if (key_debounce_timer == NULL ||
+        event_bus_subscribe(s_bus, EVENT_TOPIC_GPIO | EVENT_TOPIC_TIMER, key_level_event_handler, NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "按键事件订阅失败");
+        return;
+    }
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add(KEY_GPIO_PIN, key_level_isr_handler, NULL);
+
+    // 5. 低电平（按键按下）可以把芯片从浅睡眠中唤醒
+    ret = wake_mgr_enable_gpio(KEY_GPIO_PIN, 0);
+    key_wakeup_enabled = ret == ESP_OK;
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "GPIO 唤醒源配置失败，错误码：%d", ret);
+    }
+
     ESP_LOGI(TAG, "GPIO 输入模式初始化完成，引脚：%d", KEY_GPIO_PIN);
 }
 
 /**
- * @brief  按键状态检测任务（FreeRTOS 任务，轮询方式）
+ * @brief  LED 闪烁（每个周期的定时器事件翻转一次 LED）
  */
-void key_detect_task(void *arg)
+static void led_blink_event_handler(const event_bus_event_t *events, size_t count, void *ctx)
 {
-    uint32_t key_level = 0;  // 存储按键电平状态（0：按下，1：松开，因上拉电阻+按键接GND）
-    uint32_t last_key_level = 1;  // 存储上一次按键电平状态，初始化为松开状态
-
-    while (1) {
-        // 1. 读取 GPIO 输入电平
-        key_level = gpio_get_level(KEY_GPIO_PIN);
-
-        // 2. 检测按键状态变化（消抖：仅当电平变化时打印日志，避免重复输出）
-        if (key_level != last_key_level) {
-            if (key_level == 0) {
-                ESP_LOGI(TAG, "按键按下（电平：%d）", key_level);
-            } else {
-                ESP_LOGI(TAG, "按键松开（电平：%d）", key_level);
-            }
-            last_key_level = key_level;  // 更新上一次按键电平状态
+    static uint32_t led_level = 1;   // led_blink_start 已先点亮
+    static uint32_t toggle_count = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].id != TIMER_ID_LED_BLINK) {
+            continue;
         }
+        // 1. 定时器到期（开启 tickless idle 后等待期间进入浅睡眠），翻转 LED 电平
+        led_level = !led_level;
+        gpio_set_level(LED_GPIO_PIN, led_level);
+        ESP_LOGI(TAG, "LED %s", led_level ? "点亮" : "熄灭");
 
-        // 3. 轮询间隔：20ms（平衡响应速度和 CPU 占用，简易消抖）
-        vTaskDelay(pdMS_TO_TICKS(20));
+        // 2. 每 10 个周期（亮灭各一次为一个周期）打印一次唤醒与事件总线统计
+        if (++toggle_count % 20 == 0) {
+            wake_mgr_log_stats();
+            event_bus_log_stats(s_bus, "GPIO 事件");
+        }
     }
 }
 
 /**
- * @brief  LED 闪烁
+ * @brief  启动 LED 闪烁：订阅定时器事件，并启动 1 秒周期的定时器
  */
-void led_blink_task()
+void led_blink_start(void)
 {
-    while (1) {
-        // 1. 设置 GPIO 为高电平（LED 点亮）
-        gpio_set_level(LED_GPIO_PIN, 1);
-        ESP_LOGI(TAG, "LED 点亮");
-        vTaskDelay(pdMS_TO_TICKS(1000));  // 延时 1 秒
-
-        // 2. 设置 GPIO 为低电平（LED 熄灭）
-        gpio_set_level(LED_GPIO_PIN, 0);
-        ESP_LOGI(TAG, "LED 熄灭");
-        vTaskDelay(pdMS_TO_TICKS(1000));  // 延时 1 秒
+    esp_timer_handle_t blink_timer = timer_event_create(TIMER_ID_LED_BLINK, "led_blink");
+    if (blink_timer == NULL ||
+        event_bus_subscribe(s_bus, EVENT_TOPIC_TIMER, led_blink_event_handler, NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "LED 闪烁启动失败");
+        return;
     }
+    // 与原先一样先点亮 LED，之后每秒翻转一次
+    gpio_set_level(LED_GPIO_PIN, 1);
+    ESP_LOGI(TAG, "LED 点亮");
+    esp_timer_start_periodic(blink_timer, LED_BLINK_PERIOD_US);
 }
 
-
-bool isPressed = false;
+static esp_timer_handle_t key_confirm_timer = NULL;
 
 /**
  * @brief  GPIO 中断回调函数（中断上下文，需简洁高效，禁止耗时操作）
  * @note   1. 不能使用 ESP_LOGI/ESP_LOGE 等日志函数（可能导致死锁）
  *         2. 不能使用 vTaskDelay 等 FreeRTOS 延时函数
- *         3. 优先使用信号量/队列与任务同步
+ *         3. 只发布事件（无锁、不阻塞），具体逻辑在事件处理函数中执行
  */
 static void gpio_isr_handler(void *arg)
 {
-    isPressed = true;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    event_bus_publish_from_isr(s_bus, EVENT_TOPIC_GPIO, (uint32_t)arg, 0, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  按键中断处理（在事件总线分发任务中执行，避免中断上下文耗时操作）
+ * @note   边沿中断不能唤醒浅睡眠，需要在睡眠中响应按键请使用 gpio_input_init 的电平唤醒方式
+ */
+static void key_interrupt_event_handler(const event_bus_event_t *events, size_t count, void *ctx)
+{
+    for (size_t i = 0; i < count; i++) {
+        const event_bus_event_t *event = &events[i];
+        if (event->topic == EVENT_TOPIC_GPIO && event->id == KEY_INTERUPT_GPIO_PIN) {
+            // 1. 简易消抖：50ms 内的重复中断只处理一次（定时器运行中时 esp_timer_start_once 返回错误）
+            if (esp_timer_start_once(key_confirm_timer, KEY_CONFIRM_US) == ESP_OK) {
+                ESP_LOGI(TAG, "检测到按键中断，执行按键处理逻辑");
+            }
+        } else if (event->topic == EVENT_TOPIC_TIMER && event->id == TIMER_ID_KEY_CONFIRM) {
+            // 2. 验证按键当前状态（可选，进一步确认按键按下）
+            if (gpio_get_level(KEY_INTERUPT_GPIO_PIN) == 0) {
+                ESP_LOGI(TAG, "按键确认按下，执行具体功能");
+            }
+        }
+    }
 }
 
 /**
@@ -147,7 +328,13 @@ void gpio_interrupt_init(void)
         return;
     }
 
-    // 4. 安装 GPIO 中断服务（默认配置，共享中断）
+    // 4. 订阅按键与确认定时器事件，安装 GPIO 中断服务（默认配置，共享中断）
+    key_confirm_timer = timer_event_create(TIMER_ID_KEY_CONFIRM, "key_confirm");
+    if (key_confirm_timer == NULL ||
+        event_bus_subscribe(s_bus, EVENT_TOPIC_GPIO | EVENT_TOPIC_TIMER, key_interrupt_event_handler, NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "按键事件订阅失败");
+        return;
+    }
     gpio_install_isr_service(0);
 
     // 5. 为指定 GPIO 注册中断回调函数
@@ -161,33 +348,22 @@ void gpio_interrupt_init(void)
     ESP_LOGI(TAG, "GPIO 中断模式初始化完成，引脚：%d（下降沿触发）", KEY_INTERUPT_GPIO_PIN);
 }
 
-/**
- * @brief  按键中断处理任务（在任务中处理具体逻辑，避免中断上下文耗时操作）
- */
-void key_interrupt_task(void *arg)
+void app_main(void)
 {
-    while (1) {
-        // 1. 等待信号量（无限等待，直到中断触发）
-        if (isPressed) {
-            // 2. 处理按键逻辑（此处可添加消抖、功能执行等操作）
-            ESP_LOGI(TAG, "检测到按键中断，执行按键处理逻辑");
-            
-            // 3. 简易消抖（延时 50ms，避免电平抖动导致重复触发）
-            vTaskDelay(pdMS_TO_TICKS(50));
-            
-            // 4. 验证按键当前状态（可选，进一步确认按键按下）
-            if (gpio_get_level(KEY_INTERUPT_GPIO_PIN) == 0) {
-                ESP_LOGI(TAG, "按键确认按下，执行具体功能");
-            }
+    // 开启动态调频与自动浅睡眠（任务都阻塞时 CPU 进入浅睡眠，由定时器/GPIO 唤醒）
+    wake_mgr_config_t pm_config = WAKE_MGR_DEFAULT_CONFIG();
+    if (wake_mgr_init(&pm_config) != ESP_OK) {
+        ESP_LOGW(TAG, "电源管理未开启，请在 menuconfig 中启用 CONFIG_PM_ENABLE 和 CONFIG_FREERTOS_USE_TICKLESS_IDLE");
+    }
 
-        }
+    // 创建事件总线（按键、定时器事件都由它的分发任务处理）
+    if (gpio_event_bus_init() != ESP_OK) {
+        return;
     }
-}
 
-void app_main(void)
-{
     // 初始化 GPIO 输出模式
     gpio_output_init();
 
-    led_blink_task();
+    // LED 闪烁由定时器事件驱动，app_main 返回后不再占用任务
+    led_blink_start();
 }
\ No newline at end of file
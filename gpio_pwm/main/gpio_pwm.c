@@ -2,6 +2,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "wake_mgr.h"
 
 // ************************ 宏定义（可根据硬件修改）************************
 #define PWM_GPIO_PIN        2       // 连接 LED 的 GPIO 引脚（可替换为 19、20（释放 JTAG 后）等普通 GPIO）
@@ -10,6 +11,7 @@
 #define LEDC_FREQ_HZ        5000    // PWM 频率：5000Hz（避免 LED 闪烁，推荐 1k~10k Hz）
 #define LEDC_TIMER_RESOLUTION  LEDC_TIMER_10_BIT  // 定时器分辨率：10 位（对应占空比范围 0~1023）
 #define BREATH_DELAY_MS     10      // 呼吸灯渐变步长延时（越小，渐变越快，可修改调节流畅度）
+#define BREATH_FADE_MS      (((1 << LEDC_TIMER_RESOLUTION) * BREATH_DELAY_MS))  // 单程渐变总时长（与逐级延时的节奏一致）
 // ***********************************************************************
 
 static const char *TAG = "PWM_LED_BRIGHTNESS";
@@ -25,7 +27,7 @@ void pwm_ledc_init(void)
         .freq_hz = LEDC_FREQ_HZ,                    // PWM 频率
         .speed_mode = LEDC_LOW_SPEED_MODE,                            // 【关键修正】直接使用 0 作为默认模式（IDF 5.5.1 兼容）
         .timer_num = LEDC_TIMER,                    // 绑定定时器
-        .clk_cfg = LEDC_AUTO_CLK,                   // 自动选择时钟源
+        .clk_cfg = LEDC_USE_RC_FAST_CLK,            // RC_FAST 时钟在浅睡眠中保持运行，PWM 不会中断
     };
     // 应用定时器配置
     esp_err_t ret = ledc_timer_config(&ledc_timer);
@@ -42,6 +44,7 @@ void pwm_ledc_init(void)
         .speed_mode = LEDC_LOW_SPEED_MODE,                            // 【关键修正】直接使用 0 作为默认模式，与定时器匹配
         .hpoint = 0,                                // 高电平起始点（默认 0 即可）
         .timer_sel = LEDC_TIMER,                    // 绑定上述配置的定时器
+        .sleep_mode = LEDC_SLEEP_MODE_KEEP_ALIVE,   // 浅睡眠期间保持输出
     };
     // 应用通道配置
     ret = ledc_channel_config(&ledc_channel);
@@ -50,44 +53,51 @@ void pwm_ledc_init(void)
         return;
     }
 
+    // 3. 安装硬件渐变功能（占空比由 LEDC 硬件逐级调整，不需要 CPU 参与）
+    ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "LEDC 渐变功能安装失败，错误码：%d", ret);
+        return;
+    }
+
     ESP_LOGI(TAG, "LEDC PWM 初始化完成，引脚：%d，频率：%d Hz，分辨率：%d 位",
              PWM_GPIO_PIN, LEDC_FREQ_HZ, LEDC_TIMER_RESOLUTION);
 }
 
 /**
- * @brief  呼吸灯任务（循环调节 PWM 占空比，控制 LED 亮度变化）
+ * @brief  呼吸灯任务（LEDC 硬件渐变，控制 LED 亮度变化）
+ * @note   原先每 10ms 唤醒一次手动调整占空比（每秒约 100 次唤醒）；
+ *         现在由硬件完成整段渐变，任务每个单程只唤醒一次，期间 CPU 可以进入浅睡眠
  */
 void pwm_breath_led_task(void *arg)
 {
     // 占空比最大值（由 10 位分辨率决定：2^10 - 1 = 1023）
     uint32_t max_duty = (1 << LEDC_TIMER_RESOLUTION) - 1;
-    uint32_t current_duty = 0;  // 当前占空比
 
     while (1) {
-        // 阶段 1：占空比从 0 增加到 max_duty（LED 由暗变亮）
-        for (current_duty = 0; current_duty <= max_duty; current_duty += 1) {
-            // 1. 设置新的占空比（模式参数同样使用 0）
-            ledc_set_duty(0, LEDC_CHANNEL, current_duty);
-            // 2. 更新占空比（使配置生效）
-            ledc_update_duty(0, LEDC_CHANNEL);
-            // 3. 延时，控制渐变速度
-            vTaskDelay(pdMS_TO_TICKS(BREATH_DELAY_MS));
-        }
+        // 阶段 1：占空比从 0 渐变到 max_duty（LED 由暗变亮）
+        ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, max_duty, BREATH_FADE_MS);
+        ledc_fade_start(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
+        vTaskDelay(pdMS_TO_TICKS(BREATH_FADE_MS));
 
-        // 阶段 2：占空比从 max_duty 减少到 0（LED 由亮变暗）
-        for (current_duty = max_duty; current_duty >= 0; current_duty -= 1) {
-            // 1. 设置新的占空比（模式参数同样使用 0）
-            ledc_set_duty(0, LEDC_CHANNEL, current_duty);
-            // 2. 更新占空比（使配置生效）
-            ledc_update_duty(0, LEDC_CHANNEL);
-            // 3. 延时，控制渐变速度
-            vTaskDelay(pdMS_TO_TICKS(BREATH_DELAY_MS));
-        }
+        // 阶段 2：占空比从 max_duty 渐变到 0（LED 由亮变暗）
+        ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, 0, BREATH_FADE_MS);
+        ledc_fade_start(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
+        vTaskDelay(pdMS_TO_TICKS(BREATH_FADE_MS));
+
+        // 每个呼吸周期打印一次唤醒统计
+        wake_mgr_log_stats();
     }
 }
 
 void app_main(void)
 {
+    // 0. 开启动态调频与自动浅睡眠
+    wake_mgr_config_t pm_config = WAKE_MGR_DEFAULT_CONFIG();
+    if (wake_mgr_init(&pm_config) != ESP_OK) {
+        ESP_LOGW(TAG, "电源管理未开启，请在 menuconfig 中启用 CONFIG_PM_ENABLE 和 CONFIG_FREERTOS_USE_TICKLESS_IDLE");
+    }
+
     // 1. 初始化 LEDC PWM 配置
     pwm_ledc_init();
 
@@ -12,6 +12,9 @@
 #include "esp_chip_info.h"
 #include "esp_flash.h"
 #include "esp_system.h"
+#if CONFIG_HELLO_WORLD_BINARY_TELEMETRY
+#include "telemetry.h"
+#endif
 
 void app_main(void)
 {
@@ -21,6 +24,23 @@ void app_main(void)
     esp_chip_info_t chip_info;
     uint32_t flash_size;
     esp_chip_info(&chip_info);
+#if CONFIG_HELLO_WORLD_BINARY_TELEMETRY
+    if(esp_flash_get_size(NULL, &flash_size) != ESP_OK) {
+        printf("Get flash size failed");
+        return;
+    }
+
+    /* Send chip information and heap as binary telemetry frames (decode with telemetry_decode.py) */
+    telemetry_chip_info_t info = {
+        .target = CONFIG_IDF_TARGET,
+        .cores = chip_info.cores,
+        .features = chip_info.features,
+        .revision = chip_info.revision,
+        .flash_size = flash_size,
+    };
+    telemetry_send_chip_info(&info);
+    telemetry_send_heap();
+#else
     printf("This is %s chip with %d CPU core(s), %s%s%s%s, ",
            CONFIG_IDF_TARGET,
            chip_info.cores,
@@ -41,9 +61,14 @@ void app_main(void)
            (chip_info.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
 
     printf("Minimum free heap size: %" PRIu32 " bytes\n", esp_get_minimum_free_heap_size());
+#endif
 
     for (int i = 10; i >= 0; i--) {
+#if CONFIG_HELLO_WORLD_BINARY_TELEMETRY
+        telemetry_send_event(TELEMETRY_EVENT_RESTART_COUNTDOWN, i);
+#else
         printf("Restarting in %d seconds...\n", i);
+#endif
         vTaskDelay(1000 / portTICK_PERIOD_MS);
     }
     printf("Restarting now.\n");
@@ -2,6 +2,8 @@
 # SPDX-License-Identifier: CC0-1.0
 import hashlib
 import logging
+import os
+import sys
 from typing import Callable
 
 import pytest
@@ -10,6 +12,9 @@ from pytest_embedded_idf.utils import idf_parametrize
 from pytest_embedded_qemu.app import QemuApp
 from pytest_embedded_qemu.dut import QemuDut
 
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', 'components', 'telemetry', 'tools'))
+import telemetry_decode  # noqa: E402
+
 
 @pytest.mark.generic
 @idf_parametrize('target', ['supported_targets', 'preview_targets'], indirect=['target'])
@@ -31,6 +36,23 @@ def test_hello_world_macos(dut: IdfDut) -> None:
     dut.expect('Hello world!')
 
 
+@pytest.mark.host_test
+@pytest.mark.parametrize('config', ['telemetry'], indirect=True)
+@idf_parametrize('target', ['linux'], indirect=['target'])
+def test_hello_world_telemetry_linux(dut: IdfDut) -> None:
+    dut.expect('Hello world!')
+    decoder = telemetry_decode.Decoder()
+    messages = []
+    while len(messages) < 4:
+        messages += decoder.feed(dut.expect(rb'\x00[^\x00]+\x00', timeout=5).group(0))
+
+    chip, heap, *countdown = messages
+    assert chip.name == 'chip_info' and chip.fields['target'] == 'linux'
+    assert heap.name == 'heap' and heap.fields['min_free_heap'] <= heap.fields['free_heap']
+    assert [(m.name, m.fields['arg']) for m in countdown] == [('event', 10), ('event', 9)]
+    assert decoder.bad_chunks == 0
+
+
 def verify_elf_sha256_embedding(app: QemuApp, sha256_reported: str) -> None:
     sha256 = hashlib.sha256()
     with open(app.elf_file, 'rb') as f:
@@ -2,30 +2,52 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "event_bus.h"
+#include "trace.h"
 
 // 宏定义：按键连接的 GPIO 引脚
 #define KEY_INTERUPT_GPIO_PIN  4
 // 宏定义：中断优先级（0~3，数值越小优先级越高，避免与系统高优先级中断冲突）
 #define KEY_INTR_PRIO  1
+// 宏定义：按键确认时间（首次中断后等待抖动结束再读取电平，期间的重复中断只处理第一次）
+#define KEY_CONFIRM_US  (50 * 1000)
+// 定时器事件编号（EVENT_TOPIC_TIMER 事件的 id）
+#define TIMER_ID_KEY_CONFIRM  1
 
-// 全局信号量（用于中断与任务间的同步，避免在中断上下文执行耗时操作）
-SemaphoreHandle_t key_semaphore = NULL;
+// 中断跟踪名称（trace_start() 时分配 id，中断里只写事件）
+TRACE_LABEL_DEFINE(s_trace_gpio_isr, "gpio_isr");
+
+// 按键事件总线（中断只发布事件，具体逻辑在分发任务中执行，避免在中断上下文执行耗时操作）
+event_bus_handle_t key_event_bus = NULL;
+// 按键确认定时器（一次性，到期时发布 TIMER_ID_KEY_CONFIRM 事件）
+static esp_timer_handle_t key_confirm_timer = NULL;
+
+/**
+ * @brief  esp_timer 回调：把按键确认定时器到期转成事件（arg 为定时器事件编号）
+ */
+static void key_confirm_timer_callback(void *arg)
+{
+    event_bus_publish(key_event_bus, EVENT_TOPIC_TIMER, (uint32_t)arg, 0);
+}
 
 /**
  * @brief  GPIO 中断回调函数（中断上下文，需简洁高效，禁止耗时操作）
  * @note   1. 不能使用 ESP_LOGI/ESP_LOGE 等日志函数（可能导致死锁）
  *         2. 不能使用 vTaskDelay 等 FreeRTOS 延时函数
- *         3. 优先使用信号量/队列与任务同步
+ *         3. 只发布事件（无锁、不阻塞），由事件总线的分发任务处理
  */
 static void gpio_isr_handler(void *arg)
 {
-    // 给信号量发通知，唤醒任务处理具体逻辑
+    // 发布按键事件，必要时唤醒分发任务处理具体逻辑
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    if (key_semaphore != NULL) {
-        xSemaphoreGiveFromISR(key_semaphore, &xHigherPriorityTaskWoken);
+    TRACE_ISR_ENTER(s_trace_gpio_isr);
+    if (key_event_bus != NULL) {
+        event_bus_publish_from_isr(key_event_bus, EVENT_TOPIC_GPIO, (uint32_t)arg, 0, &xHigherPriorityTaskWoken);
         // 若唤醒了更高优先级的任务，触发任务切换
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
+    TRACE_ISR_EXIT(s_trace_gpio_isr);
 }
 
 /**
@@ -64,55 +86,58 @@ void gpio_interrupt_init(void)
 }
 
 /**
- * @brief  按键中断处理任务（在任务中处理具体逻辑，避免中断上下文耗时操作）
+ * @brief  按键中断处理（在事件总线分发任务中执行，避免中断上下文耗时操作）
+ * @note   原先由专门的按键任务等待信号量、用 vTaskDelay 消抖；分发任务不能阻塞，
+ *         改为启动一次性定时器，KEY_CONFIRM_US 后在 TIMER_ID_KEY_CONFIRM 事件中读取电平，
+ *         避免在抖动期间读到不稳定的电平
  */
-void key_interrupt_task(void *arg)
-{   
-    ESP_LOGI(TAG, "arg=%s", (char*)arg);
-    while (1) {
-        // 1. 等待信号量（无限等待，直到中断触发）
-        if (xSemaphoreTake(key_semaphore, portMAX_DELAY) == pdTRUE) {
-            // 2. 处理按键逻辑（此处可添加消抖、功能执行等操作）
-            ESP_LOGI(TAG, "检测到按键中断，执行按键处理逻辑");
-            
-            // 3. 简易消抖（延时 50ms，避免电平抖动导致重复触发）
-            vTaskDelay(pdMS_TO_TICKS(50));
-            
-            // 4. 验证按键当前状态（可选，进一步确认按键按下）
+static void key_event_handler(const event_bus_event_t *events, size_t count, void *ctx)
+{
+    for (size_t i = 0; i < count; i++) {
+        const event_bus_event_t *event = &events[i];
+        if (event->topic == EVENT_TOPIC_GPIO && event->id == KEY_INTERUPT_GPIO_PIN) {
+            // 1. 简易消抖：50ms 内的重复中断只处理一次（定时器运行中时 esp_timer_start_once 返回错误）
+            if (esp_timer_start_once(key_confirm_timer, KEY_CONFIRM_US) == ESP_OK) {
+                // 2. 处理按键逻辑（此处可添加功能执行等操作）
+                ESP_LOGI(TAG, "检测到按键中断，执行按键处理逻辑");
+            }
+        } else if (event->topic == EVENT_TOPIC_TIMER && event->id == TIMER_ID_KEY_CONFIRM) {
+            // 3. 验证按键当前状态（可选，进一步确认按键按下）
             if (gpio_get_level(KEY_INTERUPT_GPIO_PIN) == 0) {
                 ESP_LOGI(TAG, "按键确认按下，执行具体功能");
             }
         }
     }
-    vTaskDelelte(NULL);
 }
 
 void test_isr_task(void)
 {
-    // 初始化 GPIO 输出模式
-    gpio_interrupt_init();
-
-    key_semaphore = xSemaphoreCreateBinary();
-    if (key_semaphore == NULL) {
-        ESP_LOGE(TAG, "信号量创建失败");
+    // 创建事件总线（一个分发任务，优先级与原按键任务相同）
+    event_bus_config_t config = EVENT_BUS_DEFAULT_CONFIG();
+    config.capacity = 16;
+    config.dispatcher_priority = 1;
+    esp_err_t ret = event_bus_create(&config, &key_event_bus);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "事件总线创建失败，错误码：%d", ret);
         return;
     }
-    
-    TaskHandle_t isr_task_handle;// 采集任务句柄（用于挂起/恢复）
-
-    char* args = "isr_task";
-    BaseType_t ret = xTaskCreatePinnedToCore(
-        key_interrupt_task,  // 任务函数
-        "ISRTask",        // 任务名称（仅调试）
-        4096,                 // 栈大小（字节）
-        args,                 // 任务入参
-        1,                    // 优先级（低）
-        &isr_task_handle, // 任务句柄（用于挂起/恢复）
-        1                     // 绑定到CPU1（耗时任务优先CPU1）
-    );
-    if (ret != pdPASS) {
-        ESP_LOGE(TAG, "采集任务创建失败！");
+    const esp_timer_create_args_t timer_args = {
+        .callback = key_confirm_timer_callback,
+        .arg = (void *)TIMER_ID_KEY_CONFIRM,
+        .name = "key_confirm",
+    };
+    ret = esp_timer_create(&timer_args, &key_confirm_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "按键确认定时器创建失败，错误码：%d", ret);
         return;
     }
+    ret = event_bus_subscribe(key_event_bus, EVENT_TOPIC_GPIO | EVENT_TOPIC_TIMER, key_event_handler, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "按键事件订阅失败，错误码：%d", ret);
+        return;
+    }
+    TRACE_NAME(key_event_bus, "key_event_bus");
 
-}
\ No newline at end of file
+    // 初始化 GPIO 中断模式（中断注册后可能立即触发，放在事件总线就绪之后）
+    gpio_interrupt_init();
+}
@@ -3,14 +3,32 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
+#if !CONFIG_IDF_TARGET_LINUX
 #include "driver/gpio.h"
+#endif
+#include "trace.h"
 
 // ====================== 全局配置与变量 ======================
 static const char *TAG = "MultiTask";
+#if !CONFIG_IDF_TARGET_LINUX
 #include "isr.h"
+#endif
 #include "multitask.h"
 
 void app_main() {
+#if CONFIG_MULTITASK_TRACE_DEMO
+    // 跟踪演示：记录流水线运行一段时间，然后导出时间线（用 trace2perfetto.py 转换后查看）
+    trace_start();
+    test_multi_task();
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_MULTITASK_TRACE_DURATION_MS));
+    trace_dump_to_console();
+#if CONFIG_IDF_TARGET_LINUX
+    trace_dump_to_file("multitask_trace.bin");
+#endif
+#elif CONFIG_MULTITASK_SUMMARY_BINARY
+    // 二进制遥测：汇总以 COBS 帧输出到控制台，用 telemetry_decode.py 解码查看
+    test_multi_task();
+#endif
     // test_isr_task();
     // test_multi_task();
-}
\ No newline at end of file
+}
@@ -1,7 +1,39 @@
-#include "driver/gpio.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "trace.h"
+#include "flow_ctrl.h"
+#if CONFIG_MULTITASK_SUMMARY_BINARY
+#include "telemetry.h"
+#endif
+
+// 传感器数据来源：随机数模拟（默认）或高速采集（连续模式 ADC / 合成数据回放）
+#define SENSOR_USE_ACQ  (CONFIG_MULTITASK_SOURCE_ADC || CONFIG_MULTITASK_SOURCE_REPLAY)
+#if SENSOR_USE_ACQ
+#include "acq.h"
+#include "acq_source.h"
+#endif
+
+// 采集/处理任务绑定的 CPU（单核芯片和 linux 目标只有 CPU0）
+#define WORKER_CORE_ID  (portNUM_PROCESSORS > 1 ? 1 : 0)
+
+#define COLLECT_PERIOD_MS    500   // 采集周期
+#define FLOW_LOG_PERIOD      5     // 每打印几次汇总输出一次流控统计
+
+#define ACQ_BLOCK_FRAMES     256   // 高速采集：每块帧数（每帧 = 温度 + 湿度各一个转换结果）
+#define ACQ_BLOCK_COUNT      4     // 高速采集：块数（一块在填充、一块在处理，其余缓冲突发）
+#define ACQ_RAW_MAX          4095  // 12 位 ADC 原始值上限
+
+#if CONFIG_MULTITASK_SHED_DROP_NEWEST
+#define SENSOR_SHED_POLICY   FLOW_SHED_DROP_NEWEST
+#elif CONFIG_MULTITASK_SHED_DROP_OLDEST
+#define SENSOR_SHED_POLICY   FLOW_SHED_DROP_OLDEST
+#else
+#define SENSOR_SHED_POLICY   FLOW_SHED_DOWNSAMPLE
+#endif
 
 // 1. 传感器数据结构体（队列传输的数据类型）
 typedef struct {
@@ -11,62 +43,89 @@ typedef struct {
 } sensor_data_t;
 
 // 2. 全局通信/同步对象
-QueueHandle_t sensor_queue;       // 采集→处理的队列
+flow_ctrl_handle_t sensor_flow;  // 采集→处理的流控队列（满时不阻塞，按策略降载）
 SemaphoreHandle_t data_mutex;    // 保护平均值的互斥锁
 TaskHandle_t collect_task_handle;// 采集任务句柄（用于挂起/恢复）
+TaskHandle_t process_task_handle;// 处理任务句柄（遥测上报栈高水位）
+#if SENSOR_USE_ACQ
+acq_handle_t sensor_acq;         // 高速采集（按块交给处理任务）
+#endif
 
 // 3. 共享数据（需互斥锁保护）
 static float temp_avg = 0.0f;
 static float humi_avg = 0.0f;
 static int sample_count = 0;
 
+// 4. 跟踪区间名称（trace_start() 时分配 id）
+TRACE_LABEL_DEFINE(s_trace_collect, "collect");
+TRACE_LABEL_DEFINE(s_trace_process, "process");
+TRACE_LABEL_DEFINE(s_trace_print, "print");
+
 // ====================== 任务1：传感器数据采集 ======================
 void sensor_collect_task(void *arg) {
     sensor_data_t data = {0};
     while (1) {
+        TRACE_SPAN_BEGIN(s_trace_collect);
         // 模拟传感器数据采集（随机值，实际场景替换为硬件读取）
         data.temperature = 25.0f + (rand() % 100) / 10.0f; // 25.0~34.9℃
         data.humidity = 40.0f + (rand() % 300) / 10.0f;    // 40.0~69.9%
         data.sample_id = sample_count + 1;
 
-        // 发送数据到队列（阻塞超时100ms，避免队列满导致卡死）
-        if (xQueueSend(sensor_queue, &data, pdMS_TO_TICKS(100)) == pdPASS) {
+        // 发送数据到队列（不阻塞：队列满时按降载策略处理，丢弃只计数，不在这里打印日志）
+        flow_send_result_t result = flow_ctrl_send(sensor_flow, &data);
+        if (result == FLOW_SEND_OK || result == FLOW_SEND_REPLACED_OLDEST) {
             ESP_LOGD(TAG, "采集数据：ID=%d，温度=%.1f℃，湿度=%.1f%%",
                      data.sample_id, data.temperature, data.humidity);
-        } else {
-            ESP_LOGE(TAG, "队列满，采集数据发送失败！");
         }
 
         // 监控栈剩余空间（调试用，量产可删除）
         uint32_t free_stack = uxTaskGetStackHighWaterMark(NULL);
         if (free_stack < 512) { // 剩余栈<512字节，告警
-            ESP_LOGW(TAG, "采集任务栈剩余不足：%d字节", free_stack);
+            ESP_LOGW(TAG, "采集任务栈剩余不足：%" PRIu32 "字节", free_stack);
         }
+        TRACE_SPAN_END(s_trace_collect);
 
-        vTaskDelay(pdMS_TO_TICKS(500)); // 500ms采集一次
+#if CONFIG_MULTITASK_SHED_DOWNSAMPLE
+        uint32_t period_ms = COLLECT_PERIOD_MS; // 由队列抽取样本，采样率不变
+#else
+        uint32_t period_ms = COLLECT_PERIOD_MS * flow_ctrl_get_decimation(sensor_flow); // 背压时降低采样率
+#endif
+        vTaskDelay(pdMS_TO_TICKS(period_ms)); // 默认500ms采集一次
     }
     vTaskDelete(NULL); // 任务退出（循环不会执行到这里）
 }
 
+// 把一批样本合并进平均值（一批只加一次锁）
+static void sensor_accumulate(const sensor_data_t *samples, int count) {
+    float temp_sum = 0.0f;
+    float humi_sum = 0.0f;
+    for (int i = 0; i < count; i++) {
+        temp_sum += samples[i].temperature;
+        humi_sum += samples[i].humidity;
+    }
+
+    // 加互斥锁，保护共享的平均值变量
+    xSemaphoreTake(data_mutex, portMAX_DELAY);
+    temp_avg = (temp_avg * sample_count + temp_sum) / (sample_count + count);
+    humi_avg = (humi_avg * sample_count + humi_sum) / (sample_count + count);
+    sample_count += count;
+    // 释放互斥锁
+    xSemaphoreGive(data_mutex);
+}
+
 // ====================== 任务2：数据处理（计算平均值） ======================
 void data_process_task(void *arg) {
     sensor_data_t recv_data;
     while (1) {
         // 从队列接收数据（永久阻塞，直到有数据）
-        if (xQueueReceive(sensor_queue, &recv_data, portMAX_DELAY) == pdPASS) {
-            // 加互斥锁，保护共享的平均值变量
-            xSemaphoreTake(data_mutex, portMAX_DELAY);
-            
+        if (flow_ctrl_receive(sensor_flow, &recv_data, portMAX_DELAY, NULL)) {
+            TRACE_SPAN_BEGIN(s_trace_process);
             // 计算平均值
-            temp_avg = (temp_avg * sample_count + recv_data.temperature) / (sample_count + 1);
-            humi_avg = (humi_avg * sample_count + recv_data.humidity) / (sample_count + 1);
-            sample_count++;
-
-            // 释放互斥锁
-            xSemaphoreGive(data_mutex);
+            sensor_accumulate(&recv_data, 1);
 
             ESP_LOGD(TAG, "处理数据：ID=%d，累计采样%d次，平均温度=%.1f℃，平均湿度=%.1f%%",
                      recv_data.sample_id, sample_count, temp_avg, humi_avg);
+            TRACE_SPAN_END(s_trace_process);
         }
 
         vTaskDelay(pdMS_TO_TICKS(10)); // 短暂延时，释放CPU
@@ -74,43 +133,225 @@ void data_process_task(void *arg) {
     vTaskDelete(NULL);
 }
 
+#if SENSOR_USE_ACQ
+// ====================== 高速采集：按块解码与处理 ======================
+// 原始值换算为温湿度（任务上下文执行，直接写入块内的 sensor_data_t 数组），范围与随机模拟相同
+static void sensor_decode_block(const uint16_t *raw, uint32_t frames, void *items, void *ctx) {
+    sensor_data_t *out = (sensor_data_t *)items;
+    int *next_id = (int *)ctx;
+    for (uint32_t i = 0; i < frames; i++) {
+        out[i].temperature = 25.0f + raw[2 * i] * 10.0f / (ACQ_RAW_MAX + 1);    // 25.0~35.0℃
+        out[i].humidity = 40.0f + raw[2 * i + 1] * 30.0f / (ACQ_RAW_MAX + 1);   // 40.0~70.0%
+        out[i].sample_id = ++(*next_id);
+    }
+}
+
+// 处理任务（块模式）：一次取一整块样本，处理完归还，样本不再逐个经过队列复制
+void data_process_block_task(void *arg) {
+    while (1) {
+        acq_block_t *block = acq_receive(sensor_acq, portMAX_DELAY);
+        if (block == NULL) {
+            continue;
+        }
+        TRACE_SPAN_BEGIN(s_trace_process);
+        sensor_accumulate((const sensor_data_t *)block->items, block->frames);
+        TRACE_SPAN_END(s_trace_process);
+        acq_release(sensor_acq, block);
+    }
+    vTaskDelete(NULL);
+}
+
+static esp_err_t sensor_acq_create(void) {
+    static const uint8_t channels[2] = {
+#if CONFIG_MULTITASK_SOURCE_ADC
+        CONFIG_MULTITASK_ACQ_TEMP_CHANNEL, CONFIG_MULTITASK_ACQ_HUMI_CHANNEL,
+#else
+        0, 1,
+#endif
+    };
+    static int next_sample_id = 0;
+    acq_source_t *source = NULL;
+    esp_err_t ret;
+
+#if CONFIG_MULTITASK_SOURCE_ADC
+    acq_adc_config_t adc_config = {
+        .channels = channels,
+        .channel_count = 2,
+        .atten = ADC_ATTEN_DB_12,
+        .sample_freq_hz = CONFIG_MULTITASK_ACQ_RATE_HZ * 2,   // 两个通道合计
+        .frame_bytes = 256,
+    };
+    ret = acq_source_new_adc(&adc_config, &source);
+#else
+    // 合成数据：与随机模拟相同，用 rand() 生成一段原始值后循环回放
+    static acq_conv_t synth[2 * ACQ_BLOCK_FRAMES];
+    for (int i = 0; i < ACQ_BLOCK_FRAMES; i++) {
+        synth[2 * i] = (acq_conv_t) { .channel = channels[0], .raw = rand() % (ACQ_RAW_MAX + 1) };
+        synth[2 * i + 1] = (acq_conv_t) { .channel = channels[1], .raw = rand() % (ACQ_RAW_MAX + 1) };
+    }
+    acq_replay_config_t replay_config = {
+        .data = synth,
+        .count = 2 * ACQ_BLOCK_FRAMES,
+        .conv_rate_hz = CONFIG_MULTITASK_ACQ_RATE_HZ * 2,
+        .loop = true,
+        .task_priority = 1,
+    };
+    ret = acq_source_new_replay(&replay_config, &source);
+#endif
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    acq_config_t acq_config = {
+        .channels = channels,
+        .channel_count = 2,
+        .item_size = sizeof(sensor_data_t),
+        .block_frames = ACQ_BLOCK_FRAMES,
+        .block_count = ACQ_BLOCK_COUNT,
+        .decode = sensor_decode_block,
+        .decode_ctx = &next_sample_id,
+    };
+    ret = acq_create(&acq_config, source, &sensor_acq);
+    if (ret != ESP_OK) {
+        source->del(source);
+    }
+    return ret;
+}
+#endif
+
+// 模拟按键用：暂停/恢复数据采集
+static void sensor_source_suspend(void) {
+#if SENSOR_USE_ACQ
+    acq_stop(sensor_acq);
+#else
+    vTaskSuspend(collect_task_handle);
+#endif
+}
+
+static void sensor_source_resume(void) {
+#if SENSOR_USE_ACQ
+    acq_start(sensor_acq);
+#else
+    vTaskResume(collect_task_handle);
+#endif
+}
+
 // ====================== 任务3：控制台打印+任务控制 ======================
+#if SENSOR_USE_ACQ
+// 模拟按键的时间点（秒）：运行多久后暂停采集，暂停多久后恢复
+#define DEMO_SUSPEND_AFTER_S  10
+#define DEMO_RESUME_AFTER_S   5
+#endif
+
 void console_print_task(void *arg) {
     int suspend_flag = 0; // 模拟按键：0=正常，1=挂起采集任务
+    int print_count = 0;
     while (1) {
         // 模拟“按键触发”：运行10秒后挂起采集任务，5秒后恢复
-        if (sample_count > 20 && suspend_flag == 0) {
+#if SENSOR_USE_ACQ
+        // 高速采集时 sample_count 按帧计数（每秒约 CONFIG_MULTITASK_ACQ_RATE_HZ 个），改按打印次数（每秒一次）计时
+        bool suspend_due = print_count >= DEMO_SUSPEND_AFTER_S;
+        bool resume_due = print_count >= DEMO_SUSPEND_AFTER_S + DEMO_RESUME_AFTER_S;
+#else
+        bool suspend_due = sample_count > 20;
+        bool resume_due = sample_count > 30;
+#endif
+        if (suspend_due && suspend_flag == 0) {
             ESP_LOGI(TAG, "模拟按键触发：挂起采集任务！");
-            vTaskSuspend(collect_task_handle); // 挂起采集任务
+            sensor_source_suspend(); // 挂起采集任务
             suspend_flag = 1;
-        } else if (suspend_flag == 1 && sample_count > 30) {
+        } else if (suspend_flag == 1 && resume_due) {
             ESP_LOGI(TAG, "模拟按键触发：恢复采集任务！");
-            vTaskResume(collect_task_handle);  // 恢复采集任务
+            sensor_source_resume();  // 恢复采集任务
             suspend_flag = 2; // 只触发一次
         }
 
-        // 加互斥锁，读取共享的平均值
+        // 加互斥锁，只拷贝共享的平均值；格式化和控制台输出放到锁外，不阻塞处理任务
+        TRACE_SPAN_BEGIN(s_trace_print);
         xSemaphoreTake(data_mutex, portMAX_DELAY);
+        int count = sample_count;
+        float temp = temp_avg;
+        float humi = humi_avg;
+        xSemaphoreGive(data_mutex);
+#if CONFIG_MULTITASK_SUMMARY_BINARY
+        TaskHandle_t tasks[] = { collect_task_handle, process_task_handle, xTaskGetCurrentTaskHandle() };
+        telemetry_send_sensor((uint32_t)count, temp, humi);
+        telemetry_send_heap();
+        telemetry_send_tasks(tasks, sizeof(tasks) / sizeof(tasks[0]));
+#else
         ESP_LOGI(TAG, "===== 数据汇总 =====");
-        ESP_LOGI(TAG, "累计采样：%d次", sample_count);
-        ESP_LOGI(TAG, "平均温度：%.1f℃", temp_avg);
-        ESP_LOGI(TAG, "平均湿度：%.1f%%", humi_avg);
+        ESP_LOGI(TAG, "累计采样：%d次", count);
+        ESP_LOGI(TAG, "平均温度：%.1f℃", temp);
+        ESP_LOGI(TAG, "平均湿度：%.1f%%", humi);
         ESP_LOGI(TAG, "====================");
-        xSemaphoreGive(data_mutex);
+#endif
+        TRACE_SPAN_END(s_trace_print);
+
+        // 流控/采集统计（不需要持有 data_mutex）
+        if (++print_count % FLOW_LOG_PERIOD == 0) {
+#if SENSOR_USE_ACQ
+            acq_stats_t acq_stats;
+            acq_get_stats(sensor_acq, &acq_stats);
+#if CONFIG_MULTITASK_SUMMARY_BINARY
+            uint32_t counters[] = { acq_stats.conversions, acq_stats.frames, acq_stats.blocks,
+                                    acq_stats.overrun_frames, acq_stats.resyncs };
+            telemetry_send_counters(TELEMETRY_COUNTERS_ACQ, counters, sizeof(counters) / sizeof(counters[0]));
+#else
+            ESP_LOGI(TAG, "高速采集：%" PRIu32 " 帧，%" PRIu32 " 块，丢帧 %" PRIu32 "，重新对齐 %" PRIu32 " 次",
+                     acq_stats.frames, acq_stats.blocks, acq_stats.overrun_frames, acq_stats.resyncs);
+#endif
+#elif CONFIG_MULTITASK_SUMMARY_BINARY
+            flow_ctrl_stats_t flow_stats;
+            flow_ctrl_get_stats(sensor_flow, &flow_stats);
+            uint32_t counters[] = { flow_stats.offered, flow_stats.sent, flow_stats.received,
+                                    flow_stats.dropped_newest, flow_stats.dropped_oldest, flow_stats.decimated,
+                                    flow_stats.pressure_events, flow_stats.decimation, flow_stats.depth,
+                                    flow_stats.peak_depth, flow_stats.latency_avg_us, flow_stats.latency_max_us };
+            telemetry_send_counters(TELEMETRY_COUNTERS_FLOW, counters, sizeof(counters) / sizeof(counters[0]));
+#else
+            flow_ctrl_log_stats(sensor_flow, "sensor_queue");
+#endif
+        }
 
         vTaskDelay(pdMS_TO_TICKS(1000)); // 1秒打印一次
     }
     vTaskDelete(NULL);
 }
 
+#if !SENSOR_USE_ACQ
+// 背压状态变化（在采集任务中调用，状态切换很少，可以打印日志）
+static void sensor_flow_pressure_cb(bool under_pressure, void *arg) {
+    if (under_pressure) {
+        ESP_LOGW(TAG, "处理任务跟不上，sensor_queue 进入背压（抽取倍数 %" PRIu32 "）",
+                 flow_ctrl_get_decimation(sensor_flow));
+    } else {
+        ESP_LOGI(TAG, "sensor_queue 背压解除");
+    }
+}
+#endif
+
 // ====================== 主函数：创建任务/队列/互斥锁 ======================
 void test_multi_task(void) {
-    // 1. 创建队列：长度10，每个元素为sensor_data_t大小
-    sensor_queue = xQueueCreate(10, sizeof(sensor_data_t));
-    if (sensor_queue == NULL) {
+#if SENSOR_USE_ACQ
+    // 1. 创建高速采集：数据源按块产生样本，处理任务整块处理
+    if (sensor_acq_create() != ESP_OK) {
+        ESP_LOGE(TAG, "高速采集创建失败，程序退出！");
+        return;
+    }
+#else
+    // 1. 创建流控队列：每个元素为sensor_data_t大小，满时按配置的策略降载
+    flow_ctrl_config_t flow_config = {
+        .item_size = sizeof(sensor_data_t),
+        .capacity = CONFIG_MULTITASK_QUEUE_LEN,
+        .policy = SENSOR_SHED_POLICY,
+        .on_pressure = sensor_flow_pressure_cb,
+    };
+    if (flow_ctrl_create(&flow_config, &sensor_flow) != ESP_OK) {
         ESP_LOGE(TAG, "队列创建失败，程序退出！");
         return;
     }
+    TRACE_NAME(flow_ctrl_get_queue(sensor_flow), "sensor_queue");
+#endif
 
     // 2. 创建互斥锁
     data_mutex = xSemaphoreCreateMutex();
@@ -118,7 +359,28 @@ void test_multi_task(void) {
         ESP_LOGE(TAG, "互斥锁创建失败，程序退出！");
         return;
     }
+    TRACE_NAME(data_mutex, "data_mutex");
 
+#if SENSOR_USE_ACQ
+    // 3. 创建块处理任务（绑定CPU1，栈4096，优先级2），然后启动数据源
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        data_process_block_task,
+        "ProcessTask",
+        4096,
+        NULL,
+        2,                    // 优先级（中）
+        &process_task_handle,
+        WORKER_CORE_ID        // 绑定到CPU1
+    );
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "处理任务创建失败！");
+        return;
+    }
+    if (acq_start(sensor_acq) != ESP_OK) {
+        ESP_LOGE(TAG, "高速采集启动失败！");
+        return;
+    }
+#else
     // 3. 创建采集任务（绑定CPU1，栈4096，优先级1）
     BaseType_t ret = xTaskCreatePinnedToCore(
         sensor_collect_task,  // 任务函数
@@ -127,7 +389,7 @@ void test_multi_task(void) {
         NULL,                 // 任务入参
         1,                    // 优先级（低）
         &collect_task_handle, // 任务句柄（用于挂起/恢复）
-        1                     // 绑定到CPU1（耗时任务优先CPU1）
+        WORKER_CORE_ID        // 绑定到CPU1（耗时任务优先CPU1）
     );
     if (ret != pdPASS) {
         ESP_LOGE(TAG, "采集任务创建失败！");
@@ -141,13 +403,14 @@ void test_multi_task(void) {
         4096,
         NULL,
         2,                    // 优先级（中）
-        NULL,
-        1                     // 绑定到CPU1
+        &process_task_handle,
+        WORKER_CORE_ID        // 绑定到CPU1
     );
     if (ret != pdPASS) {
         ESP_LOGE(TAG, "处理任务创建失败！");
         return;
     }
+#endif
 
     // 5. 创建打印任务（绑定CPU0，栈4096，优先级3）
     ret = xTaskCreatePinnedToCore(
@@ -0,0 +1,70 @@
+# SPDX-License-Identifier: CC0-1.0
+import os
+import sys
+
+import pytest
+from pytest_embedded_idf.dut import IdfDut
+from pytest_embedded_idf.utils import idf_parametrize
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', 'components', 'trace', 'tools'))
+import trace2perfetto  # noqa: E402
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', 'components', 'telemetry', 'tools'))
+import telemetry_decode  # noqa: E402
+
+
+@pytest.mark.host_test
+@pytest.mark.parametrize('config', ['trace'], indirect=True)
+@idf_parametrize('target', ['linux'], indirect=['target'])
+def test_multitask_trace_linux(dut: IdfDut) -> None:
+    # 跟踪整条流水线：采集任务 → sensor_queue → 处理任务 → data_mutex ← 打印任务
+    dut.expect('所有任务创建完成', timeout=10)
+    dump = dut.expect(r'TRACE_BEGIN[\s\S]+?TRACE_END \d+', timeout=60).group(0)
+
+    trace = trace2perfetto.parse_trace(trace2perfetto.extract_binary(dump))
+    counts = trace2perfetto.summarize(trace)
+    assert counts.get('task_switch_in', 0) > 0
+    assert counts.get('queue_send', 0) > 0
+    assert counts.get('queue_receive', 0) > 0
+    assert counts.get('span_begin', 0) == counts.get('span_end', 0)
+
+    names = set(trace.objects.values())
+    assert {'CollectTask', 'ProcessTask', 'PrintTask', 'sensor_queue', 'data_mutex'} <= names
+    assert {'collect', 'process', 'print'} <= set(trace.labels.values())
+
+    # 每条 sensor_queue 发送都应该有一条流向处理任务的箭头
+    chrome = trace2perfetto.to_chrome_trace(trace)
+    flows = [e for e in chrome['traceEvents'] if e.get('cat') == 'queue' and e['name'] == 'sensor_queue']
+    assert any(e['ph'] == 's' for e in flows) and any(e['ph'] == 'f' for e in flows)
+
+    # 32 位时间戳展开后应覆盖整个跟踪时长（sdkconfig 默认 12 秒）
+    assert trace.events[-1].time_us - trace.events[0].time_us > 5e6
+
+
+@pytest.mark.host_test
+@pytest.mark.parametrize('config', ['telemetry'], indirect=True)
+@idf_parametrize('target', ['linux'], indirect=['target'])
+def test_multitask_telemetry_linux(dut: IdfDut) -> None:
+    # 打印任务每秒输出 sensor / heap / tasks 三条帧，每 5 次再输出一条流控计数器帧
+    dut.expect('所有任务创建完成', timeout=10)
+    decoder = telemetry_decode.Decoder()
+    messages = []
+    while not any(m.name == 'counters' for m in messages):
+        messages += decoder.feed(dut.expect(rb'\x00[^\x00]+\x00', timeout=10).group(0))
+    assert decoder.bad_chunks == 0
+
+    # 序号连续：没有丢帧或截断
+    seqs = [m.seq for m in messages]
+    assert seqs == [(seqs[0] + i) & 0xFFFF for i in range(len(seqs))]
+
+    sensors = [m.fields for m in messages if m.name == 'sensor']
+    assert len(sensors) >= 5
+    assert sensors[-1]['sample_count'] > sensors[0]['sample_count']
+    assert 25.0 <= sensors[-1]['temp_avg'] < 35.0 and 40.0 <= sensors[-1]['humi_avg'] < 70.0
+
+    tasks = next(m.fields['tasks'] for m in messages if m.name == 'tasks')
+    assert [t['name'] for t in tasks] == ['CollectTask', 'ProcessTask', 'PrintTask']
+    assert all(t['stack_hwm'] > 0 for t in tasks)
+
+    counters = next(m.fields for m in messages if m.name == 'counters')
+    assert counters['group'] == 'flow' and counters['counters']['offered'] >= counters['counters']['sent'] > 0
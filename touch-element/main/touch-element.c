@@ -7,54 +7,113 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "touch_element/touch_button.h"
+#include "touch_element/touch_element_sleep.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "event_bus.h"
+#include "wake_mgr.h"
 
 static const char *TAG = "Touch Button Example";
 
-/* Button event handler task */
-static void button_handler_task(void *arg)
+// 唤醒统计打印周期（微秒），只在打印时唤醒一次，不影响浅睡眠
+#define STATS_LOG_PERIOD_US  (10 * 1000 * 1000)
+// 定时器事件编号（EVENT_TOPIC_TIMER 事件的 id）
+#define TIMER_ID_STATS_LOG   1
+// 分发任务栈大小：只打印日志，不需要默认的 4 KB（app_main 返回后主任务的栈也会释放）
+#define BUS_DISPATCHER_STACK 3072
+
+/*
+ * 触摸、定时器事件都发布到同一个事件总线，由总线的一个分发任务处理（与 gpio 示例一致）。
+ * 触摸回调在触摸组件的任务中执行，发布时 CPU 已处于唤醒状态，唤醒分发任务只是一次任务切换，
+ * 不会多一次浅睡眠唤醒；统计打印也由定时器事件驱动，不再占用一个周期性唤醒的任务。
+ */
+static event_bus_handle_t s_bus = NULL;
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+/**
+ * @brief  esp_timer 回调（定时器中断中执行）：把定时器到期转成事件（arg 为定时器事件编号）
+ * @note   在中断中直接发布，到期时只唤醒事件总线的分发任务，不再先唤醒 esp_timer 任务
+ */
+static void IRAM_ATTR timer_event_callback(void *arg)
 {
-    (void) arg; //Unused
-    touch_elem_message_t element_message;
-    while (1) {
-        /* Waiting for touch element messages */
-        touch_element_message_receive(&element_message, portMAX_DELAY);
-        if (element_message.element_type != TOUCH_ELEM_TYPE_BUTTON) {
-            continue;
-        }
-        /* Decode message */
-        const touch_button_message_t *button_message = touch_button_get_message(&element_message);
-        if (button_message->event == TOUCH_BUTTON_EVT_ON_PRESS) {
-            ESP_LOGI(TAG, "Button[%d] Press", (int)element_message.arg);
-        } else if (button_message->event == TOUCH_BUTTON_EVT_ON_RELEASE) {
-            ESP_LOGI(TAG, "Button[%d] Release", (int)element_message.arg);
-        } else if (button_message->event == TOUCH_BUTTON_EVT_ON_LONGPRESS) {
-            ESP_LOGI(TAG, "Button[%d] LongPress", (int)element_message.arg);
-        }
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    event_bus_publish_from_isr(s_bus, EVENT_TOPIC_TIMER, (uint32_t)arg, 0, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+        esp_timer_isr_dispatch_need_yield();
     }
 }
+#define TIMER_EVENT_DISPATCH  ESP_TIMER_ISR
+#else
+/**
+ * @brief  esp_timer 回调：把定时器到期转成事件（arg 为定时器事件编号）
+ */
+static void timer_event_callback(void *arg)
+{
+    event_bus_publish(s_bus, EVENT_TOPIC_TIMER, (uint32_t)arg, 0);
+}
+#define TIMER_EVENT_DISPATCH  ESP_TIMER_TASK
+#endif
 
-//触摸事件回调函数
+//触摸事件回调函数（在触摸组件的任务中执行，只发布事件，不做耗时处理）
 static void button_handler(touch_button_handle_t out_handle, touch_button_message_t *out_message, void *arg)
 {
     (void) out_handle; //Unused
-    if (out_message->event == TOUCH_BUTTON_EVT_ON_PRESS) {
-        ESP_LOGI(TAG, "Button[%d] Press", (int)arg);
-    } else if (out_message->event == TOUCH_BUTTON_EVT_ON_RELEASE) {
-        ESP_LOGI(TAG, "Button[%d] Release", (int)arg);
-    } else if (out_message->event == TOUCH_BUTTON_EVT_ON_LONGPRESS) {
-        ESP_LOGI(TAG, "Button[%d] LongPress", (int)arg);
+    event_bus_publish(s_bus, EVENT_TOPIC_TOUCH, (uint32_t)arg, out_message->event);
+}
+
+//触摸与定时器事件处理（在事件总线分发任务中执行，一次处理一批事件）
+static void touch_event_handler(const event_bus_event_t *events, size_t count, void *ctx)
+{
+    (void) ctx; //Unused
+    for (size_t i = 0; i < count; i++) {
+        const event_bus_event_t *event = &events[i];
+        if (event->topic == EVENT_TOPIC_TIMER && event->id == TIMER_ID_STATS_LOG) {
+            // 与 gpio、gpio_pwm 示例一样定期打印唤醒与浅睡眠统计
+            wake_mgr_log_stats();
+            event_bus_log_stats(s_bus, "触摸事件");
+        } else if (event->topic != EVENT_TOPIC_TOUCH) {
+            continue;
+        } else if (event->value == TOUCH_BUTTON_EVT_ON_PRESS) {
+            ESP_LOGI(TAG, "Button[%d] Press", (int)event->id);
+        } else if (event->value == TOUCH_BUTTON_EVT_ON_RELEASE) {
+            ESP_LOGI(TAG, "Button[%d] Release", (int)event->id);
+        } else if (event->value == TOUCH_BUTTON_EVT_ON_LONGPRESS) {
+            ESP_LOGI(TAG, "Button[%d] LongPress", (int)event->id);
+        }
     }
 }
 
 void app_main(void)
 {
-    
+    /* 开启动态调频与自动浅睡眠 */
+    wake_mgr_config_t pm_config = WAKE_MGR_DEFAULT_CONFIG();
+    bool pm_enabled = wake_mgr_init(&pm_config) == ESP_OK;
+    if (!pm_enabled) {
+        ESP_LOGW(TAG, "电源管理未开启，触摸按钮将以轮询方式持续运行");
+    }
+
+    /* 创建事件总线并订阅触摸、定时器事件（触摸回调可能在 touch_element_start 后立即触发，需先就绪） */
+    event_bus_config_t bus_config = EVENT_BUS_DEFAULT_CONFIG();
+    bus_config.capacity = 16;
+    bus_config.dispatcher_stack = BUS_DISPATCHER_STACK;
+    ESP_ERROR_CHECK(event_bus_create(&bus_config, &s_bus));
+    ESP_ERROR_CHECK(event_bus_subscribe(s_bus, EVENT_TOPIC_TOUCH | EVENT_TOPIC_TIMER, touch_event_handler, NULL));
+
     /* 初始化触摸组件库 */
     touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
     ESP_ERROR_CHECK(touch_element_install(&global_config));
     ESP_LOGI(TAG, "触摸组件已安装");
 
+    /* 浅睡眠期间由触摸传感器硬件继续测量，超过阈值时唤醒 CPU，不需要软件定时轮询 */
+    if (pm_enabled) {
+        touch_elem_sleep_config_t sleep_config = {
+            .sample_count = 500,
+            .sleep_cycle = 0x1000,
+        };
+        ESP_ERROR_CHECK(touch_element_enable_light_sleep(&sleep_config));
+    }
+
     touch_button_global_config_t button_global_config = TOUCH_BUTTON_GLOBAL_DEFAULT_CONFIG();
     ESP_ERROR_CHECK(touch_button_install(&button_global_config));
     ESP_LOGI(TAG, "Touch button installed");
@@ -82,13 +141,24 @@ void app_main(void)
     /* 设置长按时间阈值 */
     ESP_ERROR_CHECK(touch_button_set_longpress(button_handle, 2000));
 
+    /* 将该按钮设为浅睡眠唤醒源 */
+    if (pm_enabled) {
+        ESP_ERROR_CHECK(touch_element_sleep_add_wakeup(button_handle));
+    }
+
     ESP_LOGI(TAG, "触摸按钮已创建");
 
     touch_element_start();
     ESP_LOGI(TAG, "开始检测触摸事件");
 
-    // // 设置处理方式为事件
-    // ESP_ERROR_CHECK(touch_button_set_dispatch_method(button_handle[i], TOUCH_ELEM_DISP_EVENT));
-    // // 启动循环处理
-    // button_handler_task(NULL);
+    /* 周期性发布统计事件，由分发任务打印唤醒与浅睡眠统计 */
+    const esp_timer_create_args_t stats_timer_args = {
+        .callback = timer_event_callback,
+        .arg = (void *)TIMER_ID_STATS_LOG,
+        .dispatch_method = TIMER_EVENT_DISPATCH,
+        .name = "stats_log",
+    };
+    esp_timer_handle_t stats_timer = NULL;
+    ESP_ERROR_CHECK(esp_timer_create(&stats_timer_args, &stats_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(stats_timer, STATS_LOG_PERIOD_US));
 }
\ No newline at end of file